@@ -5,4 +5,3 @@
 #define SF_PADDING 100
 #define SF_POINT_RADIUS 6.0
 #define POINTS_NUMBER 5
-#define EPS 1e-6
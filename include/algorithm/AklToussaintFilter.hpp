@@ -0,0 +1,165 @@
+#pragma once
+
+#include "../simd/Orientation.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Number of directions the Akl–Toussaint filter looks for extreme points
+// in: the axis directions only, or the axes and the two diagonals.
+enum class Prefilter { NONE = 0, QUADRILATERAL = 4, OCTAGON = 8 };
+
+// Akl–Toussaint interior point elimination. The extreme points of the set
+// in 4 or 8 directions form a convex polygon inside the hull; any point
+// strictly inside it can't be a hull vertex and is dropped in one linear
+// pass. Points on the polygon boundary are kept. Survivors are reported as
+// indices into the input.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicAklToussaintFilter {
+public:
+  using point_type = BasicPoint<T>;
+
+  BasicAklToussaintFilter(std::span<const point_type> points,
+                          Prefilter directions = Prefilter::OCTAGON)
+      : input_size_{points.size()} {
+    if (directions != Prefilter::NONE && points.size() >= 4) {
+      findPolygon(points, directions);
+    }
+    if (polygon_.size() < 3) {
+      survivors_.resize(points.size());
+      std::iota(survivors_.begin(), survivors_.end(), size_t{0});
+      return;
+    }
+    survivors_.reserve(points.size() / 8);
+    if constexpr (std::is_same_v<T, double>) {
+      eliminate(CoordView(points.data()), points.size());
+    } else {
+      eliminate(points);
+    }
+  }
+
+  const std::vector<size_t> &getIndices() const & { return survivors_; }
+
+  std::vector<size_t> getIndices() && { return std::move(survivors_); }
+
+  // Counter-clockwise vertices of the elimination polygon.
+  const std::vector<point_type> &getPolygon() const { return polygon_; }
+
+  size_t inputSize() const { return input_size_; }
+
+  size_t size() const { return survivors_.size(); }
+
+private:
+  size_t input_size_;
+  std::vector<size_t> survivors_;
+  std::vector<point_type> polygon_;
+  point_type min_;
+  point_type max_;
+
+  void findPolygon(std::span<const point_type> points, Prefilter directions) {
+    // diagonal keys, without overflow for integer coordinates
+    auto sum = [](const point_type &p) {
+      return predicates::wide_t<T>(p.x_) + p.y_;
+    };
+    auto diff = [](const point_type &p) {
+      return predicates::difference(p.x_, p.y_);
+    };
+    // extremes in counter-clockwise order of their directions:
+    // -y, (1, -1), +x, (1, 1), +y, (-1, 1), -x, (-1, -1)
+    std::array<point_type, 8> extreme;
+    extreme.fill(points[0]);
+    for (const auto &p : points) {
+      if (p.y_ < extreme[0].y_) {
+        extreme[0] = p;
+      }
+      if (diff(p) > diff(extreme[1])) {
+        extreme[1] = p;
+      }
+      if (p.x_ > extreme[2].x_) {
+        extreme[2] = p;
+      }
+      if (sum(p) > sum(extreme[3])) {
+        extreme[3] = p;
+      }
+      if (p.y_ > extreme[4].y_) {
+        extreme[4] = p;
+      }
+      if (diff(p) < diff(extreme[5])) {
+        extreme[5] = p;
+      }
+      if (p.x_ < extreme[6].x_) {
+        extreme[6] = p;
+      }
+      if (sum(p) < sum(extreme[7])) {
+        extreme[7] = p;
+      }
+    }
+
+    const size_t step = (directions == Prefilter::QUADRILATERAL) ? 2 : 1;
+    for (size_t i = 0; i < extreme.size(); i += step) {
+      if (polygon_.empty() || extreme[i] != polygon_.back()) {
+        polygon_.push_back(extreme[i]);
+      }
+    }
+    while (polygon_.size() > 1 && polygon_.back() == polygon_.front()) {
+      polygon_.pop_back();
+    }
+    min_ = {extreme[6].x_, extreme[0].y_};
+    max_ = {extreme[2].x_, extreme[4].y_};
+  }
+
+  // A point is strictly inside when it is left of every polygon edge. Works
+  // through the input in blocks, testing a whole block against one edge at
+  // a time with the batched orientation kernel; crosses too close to zero
+  // for the kernel's rounding are decided by the policy's predicate.
+  void eliminate(CoordView points, size_t size) {
+    constexpr size_t BLOCK_SIZE = 256;
+    double crosses[BLOCK_SIZE];
+    bool inside[BLOCK_SIZE];
+    for (size_t begin = 0; begin < size; begin += BLOCK_SIZE) {
+      const size_t end = std::min(begin + BLOCK_SIZE, size);
+      std::fill(inside, inside + (end - begin), true);
+      for (size_t i = 0; i < polygon_.size(); ++i) {
+        const point_type &a = polygon_[i];
+        const point_type &b = polygon_[(i + 1) % polygon_.size()];
+        const double bound = predicates::crossErrorBound(
+            a, b, std::max(max_.x_ - a.x_, a.x_ - min_.x_),
+            std::max(max_.y_ - a.y_, a.y_ - min_.y_));
+        simd::orientationBatch(points, begin, end, a, b, crosses);
+        for (size_t j = 0; j < end - begin; ++j) {
+          if (inside[j] && crosses[j] <= bound) {
+            inside[j] = Policy::orientation(a, b, points[begin + j]) > 0;
+          }
+        }
+      }
+      for (size_t j = 0; j < end - begin; ++j) {
+        if (!inside[j]) {
+          survivors_.push_back(begin + j);
+        }
+      }
+    }
+  }
+
+  // Other coordinate types have no batch kernel and test point by point.
+  void eliminate(std::span<const point_type> points) {
+    for (size_t i = 0; i < points.size(); ++i) {
+      bool inside = true;
+      for (size_t e = 0; e < polygon_.size() && inside; ++e) {
+        inside = Policy::orientation(polygon_[e],
+                                     polygon_[(e + 1) % polygon_.size()],
+                                     points[i]) > 0;
+      }
+      if (!inside) {
+        survivors_.push_back(i);
+      }
+    }
+  }
+};
+
+using AklToussaintFilter = BasicAklToussaintFilter<>;
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "ConvexHullEngine.hpp"
+#include "MonotoneChain.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// Approximate hull by the strip bucketing of Bentley, Faust and Preparata,
+// in O(n + 1/epsilon). The x range of the input is cut into ceil(1/epsilon)
+// vertical strips and only the lowest and highest point of each strip, and
+// of the leftmost and rightmost columns, are kept; the monotone chain over
+// them needs no sort, as the strips are already in x order.
+//
+// The hull vertices are input points, so the approximate hull lies inside
+// the exact one, and every input point is inside it or within one strip
+// width, getErrorBound() <= epsilon * (max x - min x), of it: that bounds
+// the Hausdorff distance between the two hulls.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicApproximateConvexHull : public ConvexHullEngine<T, Policy> {
+  using Base = ConvexHullEngine<T, Policy>;
+  using Point = BasicPoint<T>;
+  using Base::candidate;
+  using Base::hull_;
+  using Base::hull_indices_;
+  using Base::materializeHull;
+  using Base::points_;
+
+public:
+  using Base::processedSize;
+
+  BasicApproximateConvexHull(std::span<const Point> points, double epsilon,
+                             Prefilter prefilter = Prefilter::NONE)
+      : Base(points, prefilter) {
+    if (!(epsilon > 0 && epsilon <= 1)) {
+      throw std::invalid_argument("Epsilon must be in (0, 1]!");
+    }
+    computeHull(epsilon);
+  }
+
+  // Distance from the hull within which every input point lies, at most
+  // epsilon times the x extent of the input.
+  double getErrorBound() const { return error_bound_; }
+
+  size_t getStripsNumber() const { return low_.size(); }
+
+private:
+  static constexpr size_t NONE = SIZE_MAX;
+
+  // lowest and highest point of each strip
+  std::vector<size_t> low_;
+  std::vector<size_t> high_;
+  double error_bound_ = 0;
+
+  void computeHull(double epsilon) {
+    hull_indices_.clear();
+    const size_t n = processedSize();
+    if (n == 0) {
+      materializeHull();
+      return;
+    }
+
+    // the leftmost and rightmost columns, lowest and highest on each
+    size_t left_low = candidate(0), left_high = left_low;
+    size_t right_low = left_low, right_high = left_low;
+    for (size_t k = 1; k < n; ++k) {
+      const size_t i = candidate(k);
+      const Point &p = points_[i];
+      if (p.x_ < points_[left_low].x_) {
+        left_low = left_high = i;
+      } else if (p.x_ == points_[left_low].x_) {
+        left_low = p.y_ < points_[left_low].y_ ? i : left_low;
+        left_high = p.y_ > points_[left_high].y_ ? i : left_high;
+      }
+      if (p.x_ > points_[right_low].x_) {
+        right_low = right_high = i;
+      } else if (p.x_ == points_[right_low].x_) {
+        right_low = p.y_ < points_[right_low].y_ ? i : right_low;
+        right_high = p.y_ > points_[right_high].y_ ? i : right_high;
+      }
+    }
+
+    const double min_x = static_cast<double>(points_[left_low].x_);
+    const double extent = static_cast<double>(points_[right_low].x_) - min_x;
+    const size_t strips =
+        extent > 0 ? static_cast<size_t>(std::ceil(1 / epsilon)) : 1;
+    error_bound_ = extent / strips;
+    low_.assign(strips, NONE);
+    high_.assign(strips, NONE);
+    const double scale = extent > 0 ? strips / extent : 0;
+    for (size_t k = 0; k < n; ++k) {
+      const size_t i = candidate(k);
+      const Point &p = points_[i];
+      const size_t s = std::min(
+          static_cast<size_t>((static_cast<double>(p.x_) - min_x) * scale),
+          strips - 1);
+      if (low_[s] == NONE || p.y_ < points_[low_[s]].y_) {
+        low_[s] = i;
+      }
+      if (high_[s] == NONE || p.y_ > points_[high_[s]].y_) {
+        high_[s] = i;
+      }
+    }
+
+    // Both chains run from the lexicographically first point to the last
+    // one. Each has at most one point per strip, so both are in
+    // lexicographic order as the monotone chain needs.
+    std::vector<size_t> lower{left_low};
+    std::vector<size_t> upper{left_low, left_high};
+    for (size_t s = 0; s < strips; ++s) {
+      if (low_[s] != NONE) {
+        lower.push_back(low_[s]);
+      }
+      if (high_[s] != NONE) {
+        upper.push_back(high_[s]);
+      }
+    }
+    lower.push_back(right_low);
+    lower.push_back(right_high);
+    upper.push_back(right_high);
+
+    auto point = [this](size_t i) { return points_[i]; };
+    std::vector<size_t> chain;
+    std::vector<size_t> upper_chain;
+    monotone_chain::buildChain<false, Policy>(lower.begin(), lower.end(),
+                                              chain, point);
+    monotone_chain::buildChain<true, Policy>(upper.begin(), upper.end(),
+                                             upper_chain, point);
+    // the upper chain right to left, without the end points it shares
+    for (size_t i = upper_chain.size(); i > 2; --i) {
+      chain.push_back(upper_chain[i - 2]);
+    }
+    hull_indices_ = std::move(chain);
+    rotateToLowest();
+    materializeHull();
+  }
+
+  // The other engines start the counter-clockwise hull at the lowest (then
+  // leftmost) point, the chains start at the leftmost one.
+  void rotateToLowest() {
+    size_t lowest = 0;
+    for (size_t i = 1; i < hull_indices_.size(); ++i) {
+      const Point &p = points_[hull_indices_[i]];
+      const Point &best = points_[hull_indices_[lowest]];
+      if (p.y_ < best.y_ || (p.y_ == best.y_ && p.x_ < best.x_)) {
+        lowest = i;
+      }
+    }
+    std::rotate(hull_indices_.begin(), hull_indices_.begin() + lowest,
+                hull_indices_.end());
+  }
+};
+
+using ApproximateConvexHull = BasicApproximateConvexHull<>;
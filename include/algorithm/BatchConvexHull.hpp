@@ -0,0 +1,220 @@
+#pragma once
+
+#include "../parallel/ThreadPool.hpp"
+#include "MonotoneChain.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// Hulls of many small point sets at once. The sets come in CSR form: one
+// flat buffer of points and offsets, set s being points[offsets[s],
+// offsets[s + 1]); the hulls go out the same way, as one flat buffer of
+// vertices (and of their indices into the input buffer) with an offset
+// table.
+//
+// Each set goes through the Akl–Toussaint quadrilateral and the monotone
+// chain on scratch vectors carved from a per-task monotonic arena on the
+// stack, which is reset between sets, so sets of up to about a thousand
+// points cost no allocation at all; larger ones spill to the heap. The
+// sets are spread over the thread pool in contiguous runs, each run
+// appending to its own output that is copied to its place once every hull
+// size is known.
+//
+// Every hull is reported like the engines do: counter-clockwise from the
+// lowest (then leftmost) vertex, without collinear or duplicate points.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicBatchConvexHull {
+public:
+  using coordinate_type = T;
+  using point_type = BasicPoint<T>;
+
+  static constexpr size_t ARENA_BYTES = size_t{1} << 16;
+
+  // threads : how many runs of sets are hulled at once, 0 uses every
+  // thread of the pool
+  BasicBatchConvexHull(std::span<const point_type> points,
+                       std::span<const size_t> offsets, size_t threads = 0)
+      : points_{points} {
+    if (offsets.empty() || offsets.front() != 0 ||
+        offsets.back() != points.size() ||
+        !std::is_sorted(offsets.begin(), offsets.end())) {
+      throw std::invalid_argument("Offsets must rise from 0 to the number of "
+                                  "points!");
+    }
+    computeHulls(offsets, threads == 0 ? ThreadPool::shared().size() : threads);
+  }
+
+  // Number of sets.
+  size_t batchSize() const { return hull_offsets_.size() - 1; }
+
+  std::span<const point_type> getHull(size_t set) const {
+    return {hulls_.data() + hull_offsets_[set],
+            hull_offsets_[set + 1] - hull_offsets_[set]};
+  }
+
+  // Hull vertices of one set as indices into the flat input buffer.
+  std::span<const size_t> getHullIndices(size_t set) const {
+    return {hull_indices_.data() + hull_offsets_[set],
+            hull_offsets_[set + 1] - hull_offsets_[set]};
+  }
+
+  // The whole output in CSR form: hull s is getHulls()[getHullOffsets()[s],
+  // getHullOffsets()[s + 1]).
+  const std::vector<point_type> &getHulls() const { return hulls_; }
+
+  const std::vector<size_t> &getHullIndices() const { return hull_indices_; }
+
+  const std::vector<size_t> &getHullOffsets() const { return hull_offsets_; }
+
+private:
+  struct Key {
+    T x;
+    T y;
+    size_t index;
+  };
+
+  // smaller sets are sorted whole
+  static constexpr size_t FILTER_MIN_SIZE = 32;
+
+  std::span<const point_type> points_;
+  std::vector<point_type> hulls_;
+  std::vector<size_t> hull_indices_;
+  std::vector<size_t> hull_offsets_;
+
+  void computeHulls(std::span<const size_t> offsets, size_t threads) {
+    const size_t sets = offsets.size() - 1;
+    // a few runs per thread keep the threads busy when set sizes vary
+    const size_t runs = std::max<size_t>(1, std::min(sets, threads * 4));
+    std::vector<std::vector<size_t>> run_indices(runs);
+    // hull size of each set, then the prefix sum of them
+    hull_offsets_.assign(sets + 1, 0);
+
+    auto run_first = [&](size_t run) { return sets * run / runs; };
+    auto hull_run = [&](size_t run) {
+      std::array<std::byte, ARENA_BYTES> buffer;
+      std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+      std::vector<size_t> &out = run_indices[run];
+      for (size_t set = run_first(run); set < run_first(run + 1); ++set) {
+        const size_t before = out.size();
+        hullOf(offsets[set], offsets[set + 1], arena, out);
+        hull_offsets_[set + 1] = out.size() - before;
+        arena.release();
+      }
+    };
+    if (threads == 1) {
+      for (size_t run = 0; run < runs; ++run) {
+        hull_run(run);
+      }
+    } else {
+      ThreadPool::shared().parallelFor(runs, hull_run, threads);
+    }
+
+    for (size_t set = 0; set < sets; ++set) {
+      hull_offsets_[set + 1] += hull_offsets_[set];
+    }
+    hull_indices_.resize(hull_offsets_[sets]);
+    hulls_.resize(hull_offsets_[sets]);
+    auto copy_run = [&](size_t run) {
+      size_t at = hull_offsets_[run_first(run)];
+      for (size_t idx : run_indices[run]) {
+        hull_indices_[at] = idx;
+        hulls_[at] = points_[idx];
+        ++at;
+      }
+    };
+    if (threads == 1) {
+      for (size_t run = 0; run < runs; ++run) {
+        copy_run(run);
+      }
+    } else {
+      ThreadPool::shared().parallelFor(runs, copy_run, threads);
+    }
+  }
+
+  // Monotone chain over points_[begin, end), appending the hull's indices
+  // to `out`.
+  void hullOf(size_t begin, size_t end, std::pmr::memory_resource &arena,
+              std::vector<size_t> &out) const {
+    std::pmr::vector<Key> keys(&arena);
+    keys.reserve(end - begin);
+    collectCandidates(begin, end, keys);
+    // of duplicate points the first one in the input is kept
+    std::sort(keys.begin(), keys.end(), [](const Key &a, const Key &b) {
+      return a.x < b.x ||
+             (a.x == b.x && (a.y < b.y || (a.y == b.y && a.index < b.index)));
+    });
+    // reserved, as the arena doesn't reuse what growing would free
+    std::pmr::vector<Key> chain(&arena);
+    std::pmr::vector<Key> upper(&arena);
+    chain.reserve(keys.size());
+    upper.reserve(keys.size());
+    monotone_chain::buildHull<Policy>(
+        keys.begin(), keys.end(), chain, upper,
+        [](const Key &key) { return point_type{key.x, key.y}; });
+    appendFromLowest(chain, out);
+  }
+
+  // The points of [begin, end) that aren't strictly inside the
+  // quadrilateral of the four axis-extreme points (Akl–Toussaint): on
+  // clustered sets that drops most of them before the sort.
+  void collectCandidates(size_t begin, size_t end,
+                         std::pmr::vector<Key> &keys) const {
+    if (end - begin < FILTER_MIN_SIZE) {
+      for (size_t i = begin; i < end; ++i) {
+        keys.push_back({points_[i].x_, points_[i].y_, i});
+      }
+      return;
+    }
+    // lowest, rightmost, highest, leftmost: counter-clockwise
+    std::array<size_t, 4> extreme{begin, begin, begin, begin};
+    for (size_t i = begin + 1; i < end; ++i) {
+      const point_type &p = points_[i];
+      if (p.y_ < points_[extreme[0]].y_) {
+        extreme[0] = i;
+      }
+      if (p.x_ > points_[extreme[1]].x_) {
+        extreme[1] = i;
+      }
+      if (p.y_ > points_[extreme[2]].y_) {
+        extreme[2] = i;
+      }
+      if (p.x_ < points_[extreme[3]].x_) {
+        extreme[3] = i;
+      }
+    }
+    for (size_t i = begin; i < end; ++i) {
+      const point_type &p = points_[i];
+      bool inside = true;
+      for (size_t e = 0; e < 4 && inside; ++e) {
+        inside = Policy::orientation(points_[extreme[e]],
+                                     points_[extreme[(e + 1) % 4]], p) > 0;
+      }
+      if (!inside) {
+        keys.push_back({p.x_, p.y_, i});
+      }
+    }
+  }
+
+  // Appends the vertices starting at the lowest (then leftmost) one.
+  static void appendFromLowest(const std::pmr::vector<Key> &hull,
+                               std::vector<size_t> &out) {
+    size_t lowest = 0;
+    for (size_t i = 1; i < hull.size(); ++i) {
+      if (hull[i].y < hull[lowest].y ||
+          (hull[i].y == hull[lowest].y && hull[i].x < hull[lowest].x)) {
+        lowest = i;
+      }
+    }
+    for (size_t i = 0; i < hull.size(); ++i) {
+      out.push_back(hull[(lowest + i) % hull.size()].index);
+    }
+  }
+};
+
+using BatchConvexHull = BasicBatchConvexHull<>;
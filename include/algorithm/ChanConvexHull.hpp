@@ -1,88 +1,213 @@
 #pragma once
 
-#include "ConvexHullBase.hpp"
-#include "GrahamConvexHull.hpp"
-#include "JarvisConvexHull.hpp"
+#include "ConvexHullEngine.hpp"
+#include "MonotoneChain.hpp"
+#include "Predicates.hpp"
+#include "../parallel/ThreadPool.hpp"
+#include "../perf/PhaseCounters.hpp"
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cstdint>
+#include <span>
 #include <stdexcept>
 #include <tuple>
+#include <vector>
+
+// How Chan groups the points into its partitions of m points: runs of
+//   INDEX:   the input order, sub-hulls that typically span the whole set;
+//   X_SLABS: the points sorted by x, vertical slabs;
+//   MORTON:  the points along the Z-order curve, compact cells.
+// The spatial orders cost one sort up front and make the sub-hulls small
+// and disjoint; those strictly inside the polygon of the extreme sub-hull
+// vertices are dropped before the wrap.
+enum class ChanPartitioning { INDEX, X_SLABS, MORTON };
+
+// How a wrapping step finds the tangent from the current hull vertex to
+// each sub-hull:
+//   BINARY: a binary search from scratch, O(log m);
+//   FINGER: a walk forward from the previous step's tangent. The tangents
+//           only move counter-clockwise as the wrap goes around, so a whole
+//           wrap walks each sub-hull about once: amortized O(1) per sub-hull
+//           and step. A walk longer than log m falls back to the search.
+enum class ChanTangentSearch { BINARY, FINGER };
+
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicChanConvexHull : public ConvexHullEngine<T, Policy> {
+  using Base = ConvexHullEngine<T, Policy>;
+  using Point = BasicPoint<T>;
+  using Base::candidate;
+  using Base::hull_;
+  using Base::hull_indices_;
+  using Base::materializeHull;
+  using Base::points_;
 
-class ChanConvexHull : public ConvexHullBase {
 public:
+  using Base::processedSize;
+
   enum TURN { RIGHT_TURN = -1, COLLINEAR = 0, LEFT_TURN = 1 };
 
-  ChanConvexHull(const std::vector<Point> &points) : ConvexHullBase(points) {
+  // threads : how many sub-hulls are built at once, 0 uses every thread of
+  // the machine
+  BasicChanConvexHull(
+      std::span<const Point> points, Prefilter prefilter = Prefilter::NONE,
+      size_t threads = 1,
+      ChanPartitioning partitioning = ChanPartitioning::INDEX,
+      ChanTangentSearch tangent_search = ChanTangentSearch::FINGER)
+      : Base(points, prefilter),
+        threads_{threads == 0 ? ThreadPool::hardwareThreads() : threads},
+        partitioning_{partitioning}, tangent_search_{tangent_search} {
     if (points.size() < 3) {
       throw std::invalid_argument("At least 3 points to build convex hull");
     }
     computeHull();
   }
 
-  const std::vector<Point> &getHull() const override { return hull_; }
+  size_t getPartitionsNumber() const { return subhull_offsets_.size() - 1; }
 
-  std::vector<GrahamConvexHull> getGrahamPartitions() const {
-    return graham_partitions_;
+  // Hull of one partition of the last round, counter-clockwise from its
+  // lowest vertex.
+  std::span<const Point> getPartitionHull(size_t idx) const {
+    if (idx >= getPartitionsNumber()) {
+      throw std::invalid_argument("Wrong index for partitions!");
+    }
+    return subhull(idx);
   }
 
-  size_t getPartitionsNumber() const { return partitions_.size(); }
+  // All the sub-hulls of the last round one after the other: sub-hull p is
+  // getPartitionHulls()[getPartitionHullOffsets()[p],
+  // getPartitionHullOffsets()[p + 1]).
+  std::span<const Point> getPartitionHulls() const { return subhull_points_; }
 
-  std::vector<Point> getGrahamPartition(size_t idx) const {
-    if (idx >= graham_partitions_.size()) {
-      throw std::invalid_argument("Wrong index for partitions!");
-    }
-    return graham_partitions_[idx].getHull();
+  const std::vector<size_t> &getPartitionHullOffsets() const {
+    return subhull_offsets_;
   }
 
-  size_t size() const override { return hull_.size(); }
+  // Number of guesses for m it took to close the hull.
+  size_t getRounds() const { return rounds_; }
 
-private:
-  std::vector<std::vector<Point>> partitions_;
-  std::vector<GrahamConvexHull> graham_partitions_;
+  // The last (successful) guess for m, also the partition size.
+  size_t getPartitionSize() const { return partition_size_; }
+
+  // Sub-hulls of the last round dropped before the wrap, see
+  // ChanPartitioning.
+  size_t getCulledNumber() const { return culled_; }
 
-  // point_tuple_t : Point, graham_partition, position in partition
+  // Orientation tests of each wrapping step, the steps of all the rounds
+  // one after the other.
+  const std::vector<size_t> &getStepTests() const { return step_tests_; }
+
+private:
+  static constexpr size_t NO_FINGER = SIZE_MAX;
+
+  size_t threads_;
+  ChanPartitioning partitioning_;
+  ChanTangentSearch tangent_search_;
+  size_t rounds_ = 0;
+  size_t partition_size_ = 0;
+  size_t culled_ = 0;
+  // candidates in partition order, empty for ChanPartitioning::INDEX
+  std::vector<size_t> order_;
+  // per sub-hull, the position of the last tangent found on it
+  std::vector<size_t> fingers_;
+  std::vector<size_t> step_tests_;
+  // orientation tests since the start of the current step
+  size_t tests_ = 0;
+  // partition p is candidates [partition_offsets_[p], partition_offsets_[p+1])
+  std::vector<size_t> partition_offsets_;
+  // The sub-hulls in one buffer: sub-hull p is subhull_points_[
+  // subhull_offsets_[p], subhull_offsets_[p + 1]), with the input indices of
+  // its vertices at the same positions of subhull_indices_. The buffers keep
+  // their capacity from round to round.
+  std::vector<size_t> subhull_offsets_;
+  std::vector<Point> subhull_points_;
+  std::vector<size_t> subhull_indices_;
+
+  // point_tuple_t : Point, partition, position in its sub-hull
   using point_tuple_t = std::tuple<Point, size_t, size_t>;
 
-  void computeHull() override {
-    if (points_.size() < 6) {
-      GrahamConvexHull graham_convex_hull(points_);
-      hull_ = graham_convex_hull.getHull();
+  void computeHull() {
+    if (processedSize() < 6) {
+      {
+        perf::Phase phase("partitioning");
+        generatePartitions(processedSize());
+      }
+      {
+        perf::Phase phase("subhulls");
+        buildPartitionHulls();
+      }
+      hull_indices_ = subhull_indices_;
+      materializeHull();
+      rounds_ = 1;
+      partition_size_ = processedSize();
       return;
     }
 
-    // TODO : delete debug vector
-    // JarvisConvexHull jarvis_convex_hull(points_);
-    // std::vector<Point> debug_vec = jarvis_convex_hull.getHull();
+    // Guess the hull size: m = min(2^(2^t), n) for t = 1, 2, ... A round
+    // costs O(n log m) and gives up after m wrapping steps, so the total
+    // stays O(n log h).
+    {
+      perf::Phase phase("partitioning");
+      sortCandidates();
+    }
+    step_tests_.clear();
+    std::vector<point_tuple_t> hull_tuple;
+    rounds_ = 0;
+    bool closed = false;
+    while (!closed) {
+      TRACE_SCOPE("round");
+      ++rounds_;
+      partition_size_ = guessPartitionSize(rounds_);
+
+      {
+        perf::Phase phase("partitioning");
+        generatePartitions(partition_size_);
+      }
+      {
+        perf::Phase phase("subhulls");
+        buildPartitionHulls();
+      }
+      if (partitioning_ != ChanPartitioning::INDEX) {
+        perf::Phase phase("partitioning");
+        cullPartitionHulls();
+      }
 
-    // TODO : delete output
-    // std::cout << "Original points : " << std::endl;
-    // for (const auto &point : points_) {
-    //   point.display_log();
-    //   std::cout << std::endl;
-    // }
+      // the last guess is n, its wrap always runs to the end
+      closed = wrapPartitions(partition_size_, hull_tuple) ||
+               partition_size_ == processedSize();
+    }
 
-    // generate graham partitions
-    generatePartitions();
-    for (size_t bucket_idx = 0; bucket_idx < partitions_.size(); ++bucket_idx) {
-      graham_partitions_.push_back({partitions_[bucket_idx]});
+    hull_indices_.clear();
+    hull_indices_.reserve(hull_tuple.size());
+    for (const auto &[point, i, j] : hull_tuple) {
+      hull_indices_.push_back(subhull_indices_[subhull_offsets_[i] + j]);
     }
+    materializeHull();
+  }
 
+  // Jarvis march over the sub-hulls. Stops after max_steps steps and
+  // returns false if the hull did not close by then.
+  bool wrapPartitions(size_t max_steps,
+                      std::vector<point_tuple_t> &hull_tuple) {
     // Find entry point
+    perf::Phase entry("entry");
     point_tuple_t entry_point = findEntryPoint();
-    std::vector<point_tuple_t> hull_tuple;
+    entry.end();
+    perf::Phase wrapping("wrapping");
+    hull_tuple.clear();
     hull_tuple.push_back(entry_point);
+    fingers_.assign(getPartitionsNumber(), NO_FINGER);
 
-    // assert(std::get<0>(entry_point) == debug_vec[0]);
-
-    // Create convex hull based on graham partitions
-    size_t max_hull_size = points_.size();
-    for (size_t step = 0; step < max_hull_size; ++step) {
+    // Create convex hull based on the sub-hulls
+    for (size_t step = 0; step < max_steps; ++step) {
       point_tuple_t current_point = hull_tuple.back();
       point_tuple_t best_candidate = current_point;
       bool first = true;
+      tests_ = 0;
 
-      for (size_t partition_idx = 0; partition_idx < graham_partitions_.size();
+      for (size_t partition_idx = 0; partition_idx < getPartitionsNumber();
            ++partition_idx) {
-        const auto &subhull = graham_partitions_[partition_idx].getHull();
+        const std::span<const Point> subhull = this->subhull(partition_idx);
         assert(!subhull.empty());
 
         point_tuple_t candidate;
@@ -92,15 +217,26 @@ private:
           size_t next_pos = (pos_in_partition + 1) % subhull.size();
           Point next_point = subhull[next_pos];
           candidate = {next_point, partition_idx, next_pos};
+        } else if (subhull.size() < 3) {
+          // degenerate (collinear or duplicate) partition
+          candidate = findNextPointInPartitionLinear(
+              subhull, std::get<0>(current_point));
+          std::get<1>(candidate) = partition_idx;
+        } else if (tangent_search_ == ChanTangentSearch::FINGER &&
+                   fingers_[partition_idx] != NO_FINGER) {
+          // amortized O(1)
+          TRACE_COUNT(TANGENT_SEARCHES, 1);
+          candidate = findNextPointInPartitionFinger(
+              subhull, std::get<0>(current_point), fingers_[partition_idx]);
+          std::get<1>(candidate) = partition_idx;
         } else {
           // O(log(m))
-          // candidate = findNextPointInPartitionLinear(
-          //     subhull, std::get<0>(current_point));
-          // std::get<1>(candidate) = partition_idx;
+          TRACE_COUNT(TANGENT_SEARCHES, 1);
           candidate = findNextPointInPartitionBinSearch(
               subhull, std::get<0>(current_point));
           std::get<1>(candidate) = partition_idx;
         }
+        fingers_[partition_idx] = std::get<2>(candidate);
 
         // O(1)
         if (first ||
@@ -111,110 +247,365 @@ private:
         }
       }
 
+      step_tests_.push_back(tests_);
+      TRACE_COUNT(WRAPPING_STEPS, 1);
+
       // Close convex hull
       if (std::get<0>(best_candidate) == std::get<0>(entry_point)) {
-        break;
+        return true;
       }
 
-      // assert(debug_vec[step + 1] == std::get<0>(best_candidate));
-
       hull_tuple.push_back(best_candidate);
     }
+    return false;
+  }
 
-    hull_.clear();
-    for (const auto &[point, i, j] : hull_tuple) {
-      hull_.push_back(point);
-    }
-
-    // std::cout << "Chan algorithm : " << std::endl;
-    // for (const auto &point : hull_) {
-    //   point.display_log();
-    //   std::cout << std::endl;
-    // }
-    //
-    // std::cout << "Correct answer : " << std::endl;
-    // for (const auto &point : debug_vec) {
-    //   point.display_log();
-    //   std::cout << std::endl;
-    // }
-    //
-    // assert(hull_.size() == jarvis_convex_hull.size());
+  std::span<const Point> subhull(size_t idx) const {
+    return std::span<const Point>(subhull_points_)
+        .subspan(subhull_offsets_[idx],
+                 subhull_offsets_[idx + 1] - subhull_offsets_[idx]);
+  }
+
+  // Each partition's hull is written where its points start in the
+  // candidate order, which it can't outgrow, then the hulls are moved down
+  // to close the gaps. The partitions are independent, so with more than
+  // one thread runs of them are built on the shared pool, each run reusing
+  // its scratch vectors.
+  void buildPartitionHulls() {
+    const size_t partitions_number = partition_offsets_.size() - 1;
+    subhull_points_.resize(processedSize());
+    subhull_indices_.resize(processedSize());
+    // hull sizes first, offsets after the move
+    subhull_offsets_.assign(partitions_number + 1, 0);
+
+    auto build_run = [this](size_t first, size_t last) {
+      TRACE_SCOPE("subhull run");
+      std::vector<LexKey> keys;
+      std::vector<LexKey> chain;
+      std::vector<LexKey> upper;
+      for (size_t bucket_idx = first; bucket_idx < last; ++bucket_idx) {
+        buildPartitionHull(bucket_idx, keys, chain, upper);
+      }
+    };
+    if (threads_ == 1) {
+      build_run(0, partitions_number);
+    } else {
+      const size_t runs = std::min(partitions_number, threads_ * 4);
+      ThreadPool::shared().parallelFor(
+          runs,
+          [&](size_t run) {
+            build_run(partitions_number * run / runs,
+                      partitions_number * (run + 1) / runs);
+          },
+          threads_);
+    }
+
+    for (size_t bucket_idx = 0; bucket_idx < partitions_number; ++bucket_idx) {
+      const size_t size = subhull_offsets_[bucket_idx + 1];
+      const size_t from = partition_offsets_[bucket_idx];
+      const size_t to = subhull_offsets_[bucket_idx];
+      std::copy(subhull_points_.begin() + from,
+                subhull_points_.begin() + from + size,
+                subhull_points_.begin() + to);
+      std::copy(subhull_indices_.begin() + from,
+                subhull_indices_.begin() + from + size,
+                subhull_indices_.begin() + to);
+      subhull_offsets_[bucket_idx + 1] = to + size;
+    }
+    subhull_points_.resize(subhull_offsets_.back());
+    subhull_indices_.resize(subhull_offsets_.back());
+  }
+
+  struct LexKey {
+    T x;
+    T y;
+    size_t index;
+  };
+
+  // Puts the candidates in the order of the spatial partitioning.
+  void sortCandidates() {
+    order_.clear();
+    if (partitioning_ == ChanPartitioning::INDEX) {
+      return;
+    }
+    if (partitioning_ == ChanPartitioning::X_SLABS) {
+      std::vector<LexKey> keys(processedSize());
+      for (size_t k = 0; k < processedSize(); ++k) {
+        const Point &p = points_[candidate(k)];
+        keys[k] = {p.x_, p.y_, candidate(k)};
+      }
+      std::sort(keys.begin(), keys.end(),
+                [](const LexKey &a, const LexKey &b) { return a.x < b.x; });
+      order_.resize(processedSize());
+      for (size_t k = 0; k < processedSize(); ++k) {
+        order_[k] = keys[k].index;
+      }
+      return;
+    }
+
+    // MORTON: coordinates quantized to 32 bits over the bounding box
+    double min_x = static_cast<double>(points_[candidate(0)].x_);
+    double min_y = static_cast<double>(points_[candidate(0)].y_);
+    double max_x = min_x;
+    double max_y = min_y;
+    for (size_t k = 1; k < processedSize(); ++k) {
+      const Point &p = points_[candidate(k)];
+      min_x = std::min(min_x, static_cast<double>(p.x_));
+      min_y = std::min(min_y, static_cast<double>(p.y_));
+      max_x = std::max(max_x, static_cast<double>(p.x_));
+      max_y = std::max(max_y, static_cast<double>(p.y_));
+    }
+    static constexpr double CELLS = 4294967295.0;
+    auto quantize = [](T v, double min, double max) {
+      if (max <= min) {
+        return uint32_t{0};
+      }
+      const double cell = (static_cast<double>(v) - min) / (max - min) * CELLS;
+      return static_cast<uint32_t>(std::min(cell, CELLS));
+    };
+    std::vector<std::pair<uint64_t, size_t>> keyed(processedSize());
+    for (size_t k = 0; k < processedSize(); ++k) {
+      const Point &p = points_[candidate(k)];
+      keyed[k] = {spreadBits(quantize(p.x_, min_x, max_x)) |
+                      spreadBits(quantize(p.y_, min_y, max_y)) << 1,
+                  candidate(k)};
+    }
+    std::sort(keyed.begin(), keyed.end());
+    order_.resize(processedSize());
+    for (size_t k = 0; k < processedSize(); ++k) {
+      order_[k] = keyed[k].second;
+    }
+  }
+
+  // Bit i of v goes to bit 2i.
+  static uint64_t spreadBits(uint32_t v) {
+    uint64_t x = v;
+    x = (x | x << 16) & 0x0000FFFF0000FFFFull;
+    x = (x | x << 8) & 0x00FF00FF00FF00FFull;
+    x = (x | x << 4) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | x << 2) & 0x3333333333333333ull;
+    x = (x | x << 1) & 0x5555555555555555ull;
+    return x;
   }
 
+  // Drops the sub-hulls with no vertex outside the Akl–Toussaint octagon of
+  // all the sub-hull vertices: that octagon lies inside the hull, so none
+  // of their vertices can be on it.
+  void cullPartitionHulls() {
+    const std::vector<size_t> survivors =
+        BasicAklToussaintFilter<T, Policy>(subhull_points_, Prefilter::OCTAGON)
+            .getIndices();
+    const size_t partitions_number = getPartitionsNumber();
+    std::vector<bool> keep(partitions_number, false);
+    size_t partition = 0;
+    for (size_t position : survivors) {
+      while (subhull_offsets_[partition + 1] <= position) {
+        ++partition;
+      }
+      keep[partition] = true;
+    }
+
+    size_t kept = 0;
+    size_t to = 0;
+    for (size_t p = 0; p < partitions_number; ++p) {
+      const size_t from = subhull_offsets_[p];
+      const size_t size = subhull_offsets_[p + 1] - from;
+      if (!keep[p]) {
+        continue;
+      }
+      std::copy(subhull_points_.begin() + from,
+                subhull_points_.begin() + from + size,
+                subhull_points_.begin() + to);
+      std::copy(subhull_indices_.begin() + from,
+                subhull_indices_.begin() + from + size,
+                subhull_indices_.begin() + to);
+      subhull_offsets_[kept++] = to;
+      to += size;
+    }
+    subhull_offsets_[kept] = to;
+    subhull_offsets_.resize(kept + 1);
+    subhull_points_.resize(to);
+    subhull_indices_.resize(to);
+    culled_ = partitions_number - kept;
+  }
+
+  // Monotone chain over one partition, the hull written at the
+  // partition's start from its lowest vertex and its size recorded in
+  // subhull_offsets_[bucket_idx + 1].
+  void buildPartitionHull(size_t bucket_idx, std::vector<LexKey> &keys,
+                          std::vector<LexKey> &chain,
+                          std::vector<LexKey> &upper) {
+    const size_t begin = partition_offsets_[bucket_idx];
+    const size_t end = partition_offsets_[bucket_idx + 1];
+    keys.clear();
+    for (size_t k = begin; k < end; ++k) {
+      const size_t idx = order_.empty() ? candidate(k) : order_[k];
+      const Point &p = points_[idx];
+      keys.push_back({p.x_, p.y_, idx});
+    }
+    // of duplicate points the first candidate is kept
+    std::sort(keys.begin(), keys.end(), [](const LexKey &a, const LexKey &b) {
+      return a.x < b.x ||
+             (a.x == b.x && (a.y < b.y || (a.y == b.y && a.index < b.index)));
+    });
+    monotone_chain::buildHull<Policy>(
+        keys.begin(), keys.end(), chain, upper,
+        [](const LexKey &key) { return Point{key.x, key.y}; });
+    const size_t k = chain.size();
+
+    size_t lowest = 0;
+    for (size_t i = 1; i < k; ++i) {
+      if (y_less_compare({chain[i].x, chain[i].y},
+                         {chain[lowest].x, chain[lowest].y})) {
+        lowest = i;
+      }
+    }
+    for (size_t i = 0; i < k; ++i) {
+      const LexKey &vertex = chain[(lowest + i) % k];
+      subhull_points_[begin + i] = {vertex.x, vertex.y};
+      subhull_indices_[begin + i] = vertex.index;
+    }
+    subhull_offsets_[bucket_idx + 1] = k;
+  }
+
+  // m = min(2^(2^t), n)
+  size_t guessPartitionSize(size_t round) const {
+    const size_t set_size = processedSize();
+    if (round >= 6) {
+      return set_size;
+    }
+    size_t exponent = size_t{1} << round;
+    if (exponent >= std::bit_width(set_size)) {
+      return set_size;
+    }
+    return std::min(size_t{1} << exponent, set_size);
+  }
+
+  // Binary search for the vertex q of a counter-clockwise convex polygon such
+  // that every vertex lies left of (point, q). Halves the chain [a, b] by
+  // looking at the direction of the edges leaving hull[a] and hull[c]
+  // relative to `point`. Falls back to the linear scan when the search does
+  // not converge, which only happens on near-degenerate input.
   point_tuple_t
-  findNextPointInPartitionBinSearch(const std::vector<Point> &hull,
+  findNextPointInPartitionBinSearch(std::span<const Point> hull,
                                     const Point &point) {
-    assert(hull.size() >= 3);
+    const size_t size = hull.size();
+    assert(size >= 3);
 
-    int left = 0;
-    int mid = 0;
-    int right = hull.size();
-    int size = hull.size();
+    // edge (i, i + 1) points "down" when hull[i + 1] is left of (point,
+    // hull[i]), i.e. walking forward moves further clockwise from `point`
+    auto next_of = [&](size_t i) { return (i + 1) % size; };
+    auto is_tangent = [&](size_t i) { return isTangent(hull, point, i); };
+    auto farthest_collinear = [&](size_t i) {
+      return farthestCollinear(hull, point, i);
+    };
 
-    TURN mid_prev_turn = COLLINEAR;
-    TURN mid_next_turn = COLLINEAR;
-    TURN mid_side_turn = COLLINEAR;
-    TURN prev_turn = orientation(point, hull[0], hull[size - 1]);
-    TURN next_turn = orientation(point, hull[0], hull[(left + 1) % right]);
+    if (is_tangent(0)) {
+      return farthest_collinear(0);
+    }
 
-    while (left < right) {
-      mid = left + (right - left) / 2;
-      if (((mid - 1) % size) >= 0) {
-        mid_prev_turn = orientation(point, hull[mid], hull[(mid - 1) % size]);
-      } else {
-        mid_prev_turn = orientation(point, hull[mid], hull[size - 1]);
+    size_t a = 0;
+    size_t b = size;
+    size_t steps = 2 * std::bit_width(size) + 4;
+    while (b - a > 1 && steps--) {
+      size_t c = a + (b - a) / 2;
+      if (is_tangent(c)) {
+        return farthest_collinear(c);
       }
-      mid_next_turn = orientation(point, hull[mid], hull[(mid + 1) % size]);
-      mid_side_turn = orientation(point, hull[left], hull[mid]);
-      if (mid_prev_turn != RIGHT_TURN && mid_next_turn != RIGHT_TURN) {
-        return {hull[mid], 0, mid};
-      } else if ((mid_side_turn == LEFT_TURN &&
-                  (next_turn == RIGHT_TURN || prev_turn == next_turn)) ||
-                 (mid_side_turn == RIGHT_TURN && mid_prev_turn == RIGHT_TURN)) {
-        right = mid;
+      bool up_a = orientation(point, hull[a], hull[next_of(a)]) == RIGHT_TURN;
+      bool down_c = orientation(point, hull[c], hull[next_of(c)]) == LEFT_TURN;
+      TURN a_to_c = orientation(point, hull[a], hull[c]);
+      if (up_a) {
+        if (down_c || a_to_c == LEFT_TURN) {
+          b = c;
+        } else {
+          a = c;
+        }
       } else {
-        left = mid + 1;
-        prev_turn = static_cast<TURN>(-mid_next_turn);
-        assert(left < size);
-        next_turn = orientation(point, hull[left], hull[(left + 1) % size]);
+        if (down_c && a_to_c == RIGHT_TURN) {
+          b = c;
+        } else {
+          a = c;
+        }
       }
     }
-    return {hull[left], 0, left};
+    for (size_t i = a; i <= b && i < size; ++i) {
+      if (is_tangent(i)) {
+        return farthest_collinear(i);
+      }
+    }
+    return findNextPointInPartitionLinear(hull, point);
   }
 
-  TURN orientation(const Point &p, const Point &q, const Point &r) {
-    double cross = cross_product(p, q, r);
-    if (std::abs(cross) < EPS) {
-      return COLLINEAR;
+  // Walks from the previous tangent at `finger` while the next vertex is
+  // strictly clockwise of the current one as seen from `point`. Where that
+  // stops is the tangent unless the walk started on the wrong side of it,
+  // which only degenerate input does; a failed check, or a walk longer
+  // than the search would take, falls back to the binary search.
+  point_tuple_t findNextPointInPartitionFinger(std::span<const Point> hull,
+                                               const Point &point,
+                                               size_t finger) {
+    const size_t size = hull.size();
+    size_t budget = std::bit_width(size);
+    size_t next = (finger + 1) % size;
+    while (orientation(point, hull[finger], hull[next]) == RIGHT_TURN) {
+      if (budget-- == 0) {
+        return findNextPointInPartitionBinSearch(hull, point);
+      }
+      finger = next;
+      next = (finger + 1) % size;
+    }
+    if (orientation(point, hull[finger], hull[(finger + size - 1) % size]) ==
+        RIGHT_TURN) {
+      return findNextPointInPartitionBinSearch(hull, point);
     }
-    return (cross > 0) ? LEFT_TURN : RIGHT_TURN;
+    return farthestCollinear(hull, point, finger);
   }
 
-  bool jarvis_compare(const Point &candidate, const Point &current_candidate,
-                      const Point &current_point) {
-    double cross = cross_product(current_point, current_candidate, candidate);
-    if (std::abs(cross) < EPS) {
-      return (distance_squared(current_point, candidate) >
-              distance_squared(current_point, current_candidate));
+  // All of the sub-hull is left of or on (point, hull[i]).
+  bool isTangent(std::span<const Point> hull, const Point &point, size_t i) {
+    const size_t size = hull.size();
+    return orientation(point, hull[i], hull[(i + 1) % size]) != RIGHT_TURN &&
+           orientation(point, hull[i], hull[(i + size - 1) % size]) !=
+               RIGHT_TURN;
+  }
+
+  // The tangent vertex, moved to the next one when both are on the
+  // tangent line and the next is farther.
+  point_tuple_t farthestCollinear(std::span<const Point> hull,
+                                  const Point &point, size_t i) {
+    const size_t next = (i + 1) % hull.size();
+    if (orientation(point, hull[i], hull[next]) == COLLINEAR &&
+        Policy::closer(point, hull[i], hull[next])) {
+      i = next;
     }
-    return cross < 0;
+    return {hull[i], 0, i};
   }
 
-  static double cross_product(const Point &a, const Point &b, const Point &c) {
-    return (b.x_ - a.x_) * (c.y_ - a.y_) - (b.y_ - a.y_) * (c.x_ - a.x_);
+  TURN orientation(const Point &p, const Point &q, const Point &r) {
+    ++tests_;
+    int turn = Policy::orientation(p, q, r);
+    if (turn == 0) {
+      return COLLINEAR;
+    }
+    return (turn > 0) ? LEFT_TURN : RIGHT_TURN;
   }
 
-  double distance_squared(const Point &a, const Point &b) {
-    double dx = a.x_ - b.x_;
-    double dy = a.y_ - b.y_;
-    return dx * dx + dy * dy;
+  bool jarvis_compare(const Point &candidate, const Point &current_candidate,
+                      const Point &current_point) {
+    ++tests_;
+    int turn = Policy::orientation(current_point, current_candidate, candidate);
+    if (turn == 0) {
+      return Policy::closer(current_point, current_candidate, candidate);
+    }
+    return turn < 0;
   }
 
   point_tuple_t findEntryPoint() {
-    const Point &entry_point = graham_partitions_.front().getHull()[0];
+    const Point &entry_point = subhull(0)[0];
     point_tuple_t entry_point_tuple{entry_point, 0, 0};
-    for (size_t i = 1; i < graham_partitions_.size(); ++i) {
-      const Point &curr_point = graham_partitions_[i].getHull()[0];
+    for (size_t i = 1; i < getPartitionsNumber(); ++i) {
+      const Point &curr_point = subhull(i)[0];
       const Point &best_point = std::get<0>(entry_point_tuple);
       if (y_less_compare(curr_point, best_point)) {
         entry_point_tuple = std::make_tuple(curr_point, i, 0);
@@ -226,54 +617,29 @@ private:
   bool y_less_compare(const Point &p1, const Point &p2) {
     bool y_less = (p1.y_ < p2.y_);
     bool x_less = (p1.x_ < p2.x_);
-    bool y_eq = (std::abs(p1.y_ - p2.y_) < EPS);
+    bool y_eq = (p1.y_ == p2.y_);
     return (y_less || (y_eq && x_less));
   }
 
-  void findPartitionSize(size_t &partition_size, size_t &rem) {
-    size_t set_size = points_.size();
-    if (set_size < 6) {
-      partition_size = set_size;
-      rem = 0;
-      assert(partition_size == set_size);
-      assert(rem == 0);
-      partitions_.push_back(points_);
-      return;
-    }
-    partition_size = points_.size() * 2 / 10;
-    if (partition_size < 3) {
-      partition_size = 3;
-    }
-    rem = set_size % partition_size;
-    while (rem && rem < 3) {
-      ++partition_size;
-      rem = set_size % partition_size;
-    }
-    assert(partition_size >= 3);
-    assert(rem >= 3 || rem == 0);
-  }
-
-  void generatePartitions() {
-    size_t partition_size = 0;
-    size_t rem = 0;
-    findPartitionSize(partition_size, rem);
-    size_t partitions_number = points_.size() / partition_size + (rem != 0);
-    for (size_t point_idx = 0; point_idx < points_.size(); ++point_idx) {
-      if (point_idx % partition_size == 0) {
-        partitions_.push_back(std::vector<Point>{});
-      }
-      partitions_.back().push_back(points_[point_idx]);
+  // Splits the points by input index into groups of at most partition_size.
+  // Only the group boundaries are stored, the points are not copied.
+  void generatePartitions(size_t partition_size) {
+    partition_offsets_.clear();
+    for (size_t offset = 0; offset < processedSize();
+         offset += partition_size) {
+      partition_offsets_.push_back(offset);
     }
+    partition_offsets_.push_back(processedSize());
   }
 
-  point_tuple_t findNextPointInPartitionLinear(const std::vector<Point> &hull,
+  point_tuple_t findNextPointInPartitionLinear(std::span<const Point> hull,
                                                const Point &p) {
     int size = hull.size();
-    assert(size >= 3);
+    assert(size >= 1);
 
     for (int i = 0; i < size; ++i) {
       if (hull[i] == p) {
-        assert(0 && "point can't be in hull, processed in other branch");
+        // duplicate of the current point in another partition
         size_t next_pos = (i + 1) % size;
         return {hull[next_pos], 0, next_pos};
       }
@@ -288,3 +654,5 @@ private:
     return {hull[best_index], 0, best_index};
   }
 };
+
+using ChanConvexHull = BasicChanConvexHull<>;
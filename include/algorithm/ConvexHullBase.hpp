@@ -1,20 +1,53 @@
 #pragma once
 #include "Point.hpp"
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// Runtime interface over the double precision engines, for code that picks
+// the algorithm at runtime, like the visualizer.
 class ConvexHullBase {
 public:
   virtual ~ConvexHullBase() = default;
 
-  virtual void computeHull() = 0;
-
   virtual const std::vector<Point> &getHull() const = 0;
 
+  virtual const std::vector<size_t> &getHullIndices() const = 0;
+
+  virtual size_t processedSize() const = 0;
+
   virtual size_t size() const = 0;
+};
+
+// Holds an engine and forwards the accessors to it; only these calls are
+// virtual, the engine itself is built and run without dispatch.
+//   std::unique_ptr<ConvexHullBase> hull =
+//       std::make_unique<ConvexHullAdapter<GrahamConvexHull>>(points);
+template <typename Engine> class ConvexHullAdapter final : public ConvexHullBase {
+  static_assert(std::is_same_v<typename Engine::coordinate_type, double>,
+                "ConvexHullBase reports double precision points");
+
+public:
+  template <typename... Args>
+  explicit ConvexHullAdapter(Args &&...args)
+      : engine_(std::forward<Args>(args)...) {}
+
+  const std::vector<Point> &getHull() const override {
+    return engine_.getHull();
+  }
+
+  const std::vector<size_t> &getHullIndices() const override {
+    return engine_.getHullIndices();
+  }
+
+  size_t processedSize() const override { return engine_.processedSize(); }
+
+  size_t size() const override { return engine_.size(); }
+
+  Engine &engine() { return engine_; }
 
-protected:
-  explicit ConvexHullBase(const std::vector<Point> &points) : points_(points) {}
+  const Engine &engine() const { return engine_; }
 
-  std::vector<Point> points_;
-  std::vector<Point> hull_;
+private:
+  Engine engine_;
 };
@@ -0,0 +1,88 @@
+#pragma once
+#include "AklToussaintFilter.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Common state of the hull engines, parameterized on the coordinate type T
+// and the predicate policy (see Predicates.hpp). Engines derive from it
+// without virtual functions, so their loops inline the predicates; each
+// computes its hull in its constructor. ConvexHullAdapter (in
+// ConvexHullBase.hpp) wraps an engine when it has to be picked at runtime.
+template <typename T, typename Policy> class ConvexHullEngine {
+public:
+  using coordinate_type = T;
+  using point_type = BasicPoint<T>;
+  using policy_type = Policy;
+
+  const std::vector<point_type> &getHull() const { return hull_; }
+
+  size_t size() const { return hull_.size(); }
+
+  // Hull vertices as indices into the caller's buffer, in the same
+  // counter-clockwise order as getHull().
+  const std::vector<size_t> &getHullIndices() const { return hull_indices_; }
+
+  // Number of points the engine actually processed, after the optional
+  // Akl–Toussaint pre-filter.
+  size_t processedSize() const { return processed_; }
+
+protected:
+  // The input is not copied: points_ views the caller's buffer and is only
+  // read while the derived constructor computes the hull.
+  explicit ConvexHullEngine(std::span<const point_type> points,
+                            Prefilter prefilter = Prefilter::NONE)
+      : points_(points), subset_{prefilter != Prefilter::NONE} {
+    if (subset_) {
+      candidates_ =
+          BasicAklToussaintFilter<T, Policy>(points, prefilter).getIndices();
+    }
+    processed_ = candidatesNumber();
+  }
+
+  // Hull of the points_[i] for i in `subset` only.
+  ConvexHullEngine(std::span<const point_type> points,
+                   std::vector<size_t> subset)
+      : points_(points), subset_{true}, candidates_(std::move(subset)),
+        processed_{candidates_.size()} {}
+
+  std::span<const point_type> points_;
+  std::vector<size_t> hull_indices_;
+  std::vector<point_type> hull_;
+
+  // The points the engine works on are points_[candidate(k)] for k in
+  // [0, candidatesNumber()): every point, or a subset of them.
+  size_t candidatesNumber() const {
+    return subset_ ? candidates_.size() : points_.size();
+  }
+
+  size_t candidate(size_t k) const { return subset_ ? candidates_[k] : k; }
+
+  // Candidate indices as a vector the engine may reorder, candidate() can't
+  // be used afterwards.
+  std::vector<size_t> takeCandidates() {
+    if (!subset_) {
+      std::vector<size_t> all(points_.size());
+      std::iota(all.begin(), all.end(), size_t{0});
+      return all;
+    }
+    return std::move(candidates_);
+  }
+
+  // Fills hull_ from hull_indices_.
+  void materializeHull() {
+    hull_.clear();
+    hull_.reserve(hull_indices_.size());
+    for (size_t idx : hull_indices_) {
+      hull_.push_back(points_[idx]);
+    }
+  }
+
+private:
+  bool subset_;
+  std::vector<size_t> candidates_;
+  size_t processed_;
+};
@@ -0,0 +1,459 @@
+#pragma once
+
+#include "../parallel/ThreadPool.hpp"
+#include "ConvexHullBase.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+enum class HullLocation { OUTSIDE, BOUNDARY, INSIDE };
+
+// Queries against a computed hull in O(log h), for when a hull is built
+// once and asked about many times. The hull must be given like the engines
+// report it: counter-clockwise from the lowest (then leftmost) vertex,
+// strictly convex; vertex indices in the answers are positions in it.
+//
+// From the lowest vertex the edge directions only turn left and stay in
+// [0, 2pi), so they are sorted by angle: the vertex extreme in a direction
+// is a binary search over them. Point location is a binary search over the
+// fan of triangles from the first vertex; tangents and line crossings
+// split the boundary at a known vertex on each side and binary search the
+// two monotone runs.
+//
+// locate() over a span of queries runs the fan search for a block of
+// queries at once with every query doing the same steps, on the floating
+// point orientation with its error bound; the few queries too close to an
+// edge for that are redone with the exact predicate.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicConvexPolygonIndex {
+public:
+  using coordinate_type = T;
+  using point_type = BasicPoint<T>;
+
+  // Tangent vertices from an outside point: the hull is left of (point,
+  // right) and right of (point, left). When an edge lies on a tangent line
+  // the vertex nearer to the point is taken.
+  struct Tangents {
+    size_t right;
+    size_t left;
+  };
+
+  explicit BasicConvexPolygonIndex(std::span<const point_type> hull)
+      : vertices_(hull.begin(), hull.end()) {
+    validate();
+    const size_t h = vertices_.size();
+    edges_.reserve(h);
+    for (size_t i = 0; i < h; ++i) {
+      edges_.push_back(between(vertices_[i], vertices_[(i + 1) % h]));
+    }
+    if constexpr (std::is_same_v<T, double>) {
+      xs_.reserve(h);
+      ys_.reserve(h);
+      for (const point_type &vertex : vertices_) {
+        xs_.push_back(vertex.x_);
+        ys_.push_back(vertex.y_);
+      }
+    }
+  }
+
+  explicit BasicConvexPolygonIndex(const ConvexHullBase &hull)
+    requires std::is_same_v<T, double>
+      : BasicConvexPolygonIndex(std::span<const point_type>(hull.getHull())) {}
+
+  size_t size() const { return vertices_.size(); }
+
+  const std::vector<point_type> &getVertices() const { return vertices_; }
+
+  HullLocation locate(const point_type &point) const {
+    return fan(point).location;
+  }
+
+  bool contains(const point_type &point) const {
+    return locate(point) != HullLocation::OUTSIDE;
+  }
+
+  // Locates every query, out[i] for queries[i], in blocks spread over
+  // `threads` tasks of the shared pool (0: one per thread of the pool).
+  void locate(std::span<const point_type> queries, std::span<HullLocation> out,
+              size_t threads = 1) const {
+    if (queries.size() != out.size()) {
+      throw std::invalid_argument("One location per query!");
+    }
+    const size_t blocks = (queries.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    auto locate_block = [&](size_t block) {
+      const size_t begin = block * BLOCK_SIZE;
+      const size_t end = std::min(begin + BLOCK_SIZE, queries.size());
+      if constexpr (std::is_same_v<T, double>) {
+        if (vertices_.size() >= 3) {
+          locateBlock(queries.subspan(begin, end - begin),
+                      out.subspan(begin, end - begin));
+          return;
+        }
+      }
+      for (size_t i = begin; i < end; ++i) {
+        out[i] = locate(queries[i]);
+      }
+    };
+    if (threads == 1) {
+      for (size_t block = 0; block < blocks; ++block) {
+        locate_block(block);
+      }
+    } else {
+      ThreadPool::shared().parallelFor(blocks, locate_block, threads);
+    }
+  }
+
+  // Index of the vertex farthest in `direction`; of the two ends of an
+  // edge perpendicular to it, the first one counter-clockwise.
+  size_t extremeVertex(const point_type &direction) const {
+    if (direction == point_type{}) {
+      throw std::invalid_argument("The direction must not be zero!");
+    }
+    if (vertices_.empty()) {
+      throw std::invalid_argument("The hull is empty!");
+    }
+    return extreme({static_cast<calc_t>(direction.x_),
+                    static_cast<calc_t>(direction.y_)});
+  }
+
+  // Tangents from `point`, none when it is on or inside the hull.
+  std::optional<Tangents> tangents(const point_type &point) const {
+    const size_t h = vertices_.size();
+    const Fan located = fan(point);
+    if (located.location != HullLocation::OUTSIDE || h == 0) {
+      return std::nullopt;
+    }
+    if (h == 1) {
+      return Tangents{0, 0};
+    }
+    if (h == 2) {
+      const int turn = Policy::orientation(point, vertices_[0], vertices_[1]);
+      if (turn == 0) {
+        const size_t nearer =
+            Policy::closer(point, vertices_[0], vertices_[1]) ? 0 : 1;
+        return Tangents{nearer, nearer};
+      }
+      return turn > 0 ? Tangents{0, 1} : Tangents{1, 0};
+    }
+
+    // edge i is seen from the point when the point is right of it; the seen
+    // edges are one run around the boundary
+    auto seen = [&](size_t i) {
+      return Policy::orientation(vertices_[i], vertices_[(i + 1) % h],
+                                 point) < 0;
+    };
+    const size_t a = located.edge;
+    // the vertex farthest behind edge a has an unseen edge next to it
+    const size_t w = extreme({-edges_[a].y, edges_[a].x});
+    const size_t b = seen(w) ? (w + h - 1) % h : w;
+
+    // the right tangent ends the run of seen edges after a, the left one
+    // starts it after b
+    const size_t right =
+        firstFrom(a, (b + h - a) % h, [&](size_t i) { return !seen(i); });
+    const size_t left = firstFrom(b, (a + h - b) % h, seen);
+    return Tangents{right, left};
+  }
+
+  // Where the line through a and b meets the hull: a + t (b - a) is in the
+  // hull for t in [first, second], computed in double. None when the line
+  // misses it.
+  std::optional<std::pair<double, double>>
+  intersectLine(const point_type &a, const point_type &b) const {
+    if (a == b) {
+      throw std::invalid_argument("The line needs two distinct points!");
+    }
+    const size_t h = vertices_.size();
+    if (h == 0) {
+      return std::nullopt;
+    }
+    // the vertices farthest left and right of the line
+    const Vector line = between(a, b);
+    const size_t top = extreme({-line.y, line.x});
+    const size_t bottom = extreme({line.y, -line.x});
+    auto side = [&](size_t i) {
+      return Policy::orientation(a, b, vertices_[i]);
+    };
+    if (side(top) < 0 || side(bottom) > 0) {
+      return std::nullopt;
+    }
+
+    const double dx = static_cast<double>(b.x_) - static_cast<double>(a.x_);
+    const double dy = static_cast<double>(b.y_) - static_cast<double>(a.y_);
+    auto along = [&](size_t i) {
+      const point_type &v = vertices_[i];
+      return ((static_cast<double>(v.x_) - static_cast<double>(a.x_)) * dx +
+              (static_cast<double>(v.y_) - static_cast<double>(a.y_)) * dy) /
+             (dx * dx + dy * dy);
+    };
+    auto offset = [&](size_t i) {
+      const point_type &v = vertices_[i];
+      return dx * (static_cast<double>(v.y_) - static_cast<double>(a.y_)) -
+             dy * (static_cast<double>(v.x_) - static_cast<double>(a.x_));
+    };
+    double first = std::numeric_limits<double>::infinity();
+    double second = -first;
+    auto add = [&](double t) {
+      first = std::min(first, t);
+      second = std::max(second, t);
+    };
+    // the side of the vertices rises from bottom to top and falls back
+    for (bool rising : {true, false}) {
+      const size_t from = rising ? bottom : top;
+      const size_t to = rising ? top : bottom;
+      // the first vertex on or past the line and the one before it
+      const size_t c = firstFrom(from, (to + h - from) % h, [&](size_t i) {
+        return rising ? side(i) >= 0 : side(i) <= 0;
+      });
+      const size_t previous = (c + h - 1) % h;
+      if (side(c) == 0) {
+        add(along(c));
+        // an edge on the line
+        for (size_t neighbour : {previous, (c + 1) % h}) {
+          if (side(neighbour) == 0) {
+            add(along(neighbour));
+          }
+        }
+      } else {
+        const double before = offset(previous);
+        const double after = offset(c);
+        const double ratio = std::clamp(before / (before - after), 0.0, 1.0);
+        add(along(previous) + ratio * (along(c) - along(previous)));
+      }
+    }
+    return std::make_pair(first, second);
+  }
+
+private:
+  static constexpr size_t BLOCK_SIZE = 256;
+
+  // Edge vectors and directions: exact for integer coordinates, rounded
+  // differences of the coordinates otherwise.
+  using calc_t =
+      std::conditional_t<std::is_integral_v<T>, predicates::wide_t<T>, double>;
+
+  struct Vector {
+    calc_t x;
+    calc_t y;
+  };
+
+  struct Fan {
+    HullLocation location;
+    // for a point outside, an edge it sees
+    size_t edge;
+  };
+
+  std::vector<point_type> vertices_;
+  std::vector<Vector> edges_;
+  // the vertices again as columns, for the batched location
+  std::vector<double> xs_;
+  std::vector<double> ys_;
+
+  static Vector between(const point_type &from, const point_type &to) {
+    return {static_cast<calc_t>(to.x_) - static_cast<calc_t>(from.x_),
+            static_cast<calc_t>(to.y_) - static_cast<calc_t>(from.y_)};
+  }
+
+  static int crossSign(const Vector &u, const Vector &v) {
+    if constexpr (std::is_integral_v<T>) {
+      const calc_t cross = u.x * v.y - u.y * v.x;
+      return (cross > 0) - (cross < 0);
+    } else {
+      return predicates::orientation({0, 0}, {u.x, u.y}, {v.x, v.y});
+    }
+  }
+
+  // u comes before v counter-clockwise from the positive x axis.
+  static bool angleLess(const Vector &u, const Vector &v) {
+    auto lower_half = [](const Vector &w) {
+      return w.y < 0 || (w.y == 0 && w.x < 0);
+    };
+    if (lower_half(u) != lower_half(v)) {
+      return lower_half(v);
+    }
+    return crossSign(u, v) > 0;
+  }
+
+  void validate() const {
+    const size_t h = vertices_.size();
+    bool valid = true;
+    for (size_t i = 1; i < h; ++i) {
+      valid = valid && (vertices_[0].y_ < vertices_[i].y_ ||
+                        (vertices_[0].y_ == vertices_[i].y_ &&
+                         vertices_[0].x_ < vertices_[i].x_));
+    }
+    for (size_t i = 0; h >= 3 && i < h; ++i) {
+      valid = valid && Policy::orientation(vertices_[i], vertices_[(i + 1) % h],
+                                           vertices_[(i + 2) % h]) > 0;
+    }
+    if (!valid) {
+      throw std::invalid_argument("The hull must be strictly convex and "
+                                  "counter-clockwise from its lowest vertex!");
+    }
+  }
+
+  // First vertex i = (from + j) % h, j in [0, length], with pred(i); pred
+  // is false then true on that range and true at its end.
+  template <typename Pred>
+  size_t firstFrom(size_t from, size_t length, Pred &&pred) const {
+    const size_t h = vertices_.size();
+    size_t low = 0;
+    size_t high = length;
+    while (low < high) {
+      const size_t mid = low + (high - low) / 2;
+      if (pred((from + mid) % h)) {
+        high = mid;
+      } else {
+        low = mid + 1;
+      }
+    }
+    return (from + low) % h;
+  }
+
+  // The vertex farthest in `direction`: where the edges turn past the
+  // direction rotated by a quarter turn.
+  size_t extreme(const Vector &direction) const {
+    const size_t h = vertices_.size();
+    const Vector target{-direction.y, direction.x};
+    if (h < 3) {
+      if (h == 1) {
+        return 0;
+      }
+      // ahead along the edge from 0 to 1 or not
+      const int turn = crossSign(target, edges_[0]);
+      return turn < 0 ? 1 : 0;
+    }
+    const auto it = std::lower_bound(
+        edges_.begin(), edges_.end(), target,
+        [](const Vector &edge, const Vector &t) { return angleLess(edge, t); });
+    return it == edges_.end() ? 0 : static_cast<size_t>(it - edges_.begin());
+  }
+
+  Fan fan(const point_type &point) const {
+    const size_t h = vertices_.size();
+    if (h < 3) {
+      return {locateDegenerate(point), 0};
+    }
+    const int first = Policy::orientation(vertices_[0], vertices_[1], point);
+    if (first < 0) {
+      return {HullLocation::OUTSIDE, 0};
+    }
+    const int last = Policy::orientation(vertices_[0], vertices_[h - 1], point);
+    if (last > 0) {
+      return {HullLocation::OUTSIDE, h - 1};
+    }
+    // the last k in [1, h - 2] with the point left of or on (v0, vk): the
+    // point is in the wedge of triangle (v0, vk, vk+1)
+    size_t k = 1;
+    for (size_t count = h - 2; count > 1;) {
+      const size_t half = count / 2;
+      if (Policy::orientation(vertices_[0], vertices_[k + half], point) >= 0) {
+        k += half;
+      }
+      count -= half;
+    }
+    const int turn = Policy::orientation(vertices_[k], vertices_[k + 1], point);
+    if (turn < 0) {
+      return {HullLocation::OUTSIDE, k};
+    }
+    if (turn == 0 || (k == 1 && first == 0) || (k == h - 2 && last == 0)) {
+      return {HullLocation::BOUNDARY, k};
+    }
+    return {HullLocation::INSIDE, k};
+  }
+
+  // An empty hull, one vertex or a segment.
+  HullLocation locateDegenerate(const point_type &point) const {
+    const size_t h = vertices_.size();
+    if (h == 0) {
+      return HullLocation::OUTSIDE;
+    }
+    if (h == 1) {
+      return point == vertices_[0] ? HullLocation::BOUNDARY
+                                   : HullLocation::OUTSIDE;
+    }
+    const point_type &a = vertices_[0];
+    const point_type &b = vertices_[1];
+    if (Policy::orientation(a, b, point) != 0) {
+      return HullLocation::OUTSIDE;
+    }
+    const bool between = !Policy::closer(a, b, point) &&
+                         !Policy::closer(b, a, point);
+    return between ? HullLocation::BOUNDARY : HullLocation::OUTSIDE;
+  }
+
+  // The fan search of fan() for a block of double queries in lockstep: every
+  // query makes the same number of steps and only its position differs, so
+  // the loops over the block have no branches to diverge on. A cross
+  // product within its error bound of zero marks the query unsure, and
+  // unsure queries go through the exact locate() afterwards.
+  void locateBlock(std::span<const point_type> queries,
+                   std::span<HullLocation> out) const {
+    const size_t n = queries.size();
+    const size_t h = vertices_.size();
+    const double *xs = xs_.data();
+    const double *ys = ys_.data();
+    double qx[BLOCK_SIZE];
+    double qy[BLOCK_SIZE];
+    size_t k[BLOCK_SIZE];
+    int outside[BLOCK_SIZE];
+    int unsure[BLOCK_SIZE];
+
+    // sign of (b - a) x (q - a), or 0 when the rounding could flip it
+    auto sign = [](double ax, double ay, double bx, double by, double cx,
+                   double cy) {
+      const double detleft = (bx - ax) * (cy - ay);
+      const double detright = (by - ay) * (cx - ax);
+      const double det = detleft - detright;
+      const double bound = predicates::CCW_ERROR_BOUND *
+                           (std::abs(detleft) + std::abs(detright));
+      return (det > bound) - (-det > bound);
+    };
+
+    for (size_t i = 0; i < n; ++i) {
+      qx[i] = queries[i].x_;
+      qy[i] = queries[i].y_;
+      const int first = sign(xs[0], ys[0], xs[1], ys[1], qx[i], qy[i]);
+      const int last =
+          sign(xs[0], ys[0], xs[h - 1], ys[h - 1], qx[i], qy[i]);
+      outside[i] = (first < 0) | (last > 0);
+      unsure[i] = (first == 0) | (last == 0);
+      k[i] = 1;
+    }
+    for (size_t count = h - 2; count > 1;) {
+      const size_t half = count / 2;
+      for (size_t i = 0; i < n; ++i) {
+        const size_t m = k[i] + half;
+        const int turn = sign(xs[0], ys[0], xs[m], ys[m], qx[i], qy[i]);
+        unsure[i] |= turn == 0;
+        k[i] += turn > 0 ? half : 0;
+      }
+      count -= half;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      const size_t j = k[i];
+      const int turn = sign(xs[j], ys[j], xs[j + 1], ys[j + 1], qx[i], qy[i]);
+      // far outside, the wedge search and its last test don't matter
+      unsure[i] = (!outside[i]) & (unsure[i] | (turn == 0));
+      outside[i] |= turn < 0;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (unsure[i]) {
+        out[i] = locate(queries[i]);
+      } else {
+        out[i] = outside[i] ? HullLocation::OUTSIDE : HullLocation::INSIDE;
+      }
+    }
+  }
+};
+
+using ConvexPolygonIndex = BasicConvexPolygonIndex<>;
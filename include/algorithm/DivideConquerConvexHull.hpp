@@ -0,0 +1,307 @@
+#pragma once
+
+#include "../parallel/ForkJoinPool.hpp"
+#include "ConvexHullEngine.hpp"
+#include "MonotoneChain.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <span>
+#include <vector>
+
+// Parallel divide and conquer. The points are cut by x into slabs of about
+// LEAF_SIZE points at sampled x quantiles, in one parallel bucketing pass,
+// so every slab lies strictly left of the next. The slabs' hulls are found
+// with the monotone chain and merged pairwise up a balanced tree whose
+// halves are forked on a work-stealing pool; a merge joins the lower (and
+// upper) chains of two x-separated hulls at their bridge, walking in from
+// the facing ends, O(h). A slab that came out too large, as with many
+// points sharing one x, is split further at its (x, y) median.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicDivideConquerConvexHull : public ConvexHullEngine<T, Policy> {
+  using Base = ConvexHullEngine<T, Policy>;
+  using Point = BasicPoint<T>;
+  using Base::candidate;
+  using Base::hull_;
+  using Base::hull_indices_;
+  using Base::materializeHull;
+  using Base::points_;
+
+public:
+  using Base::processedSize;
+
+  static constexpr size_t LEAF_SIZE = size_t{1} << 15;
+
+  // threads : size of the fork/join pool, 0 uses every thread of the
+  // machine, 1 runs sequentially
+  BasicDivideConquerConvexHull(std::span<const Point> points,
+                               Prefilter prefilter = Prefilter::NONE,
+                               size_t threads = 0)
+      : Base(points, prefilter) {
+    const size_t shared = ForkJoinPool::shared().size();
+    if (threads == 0 || threads == shared) {
+      pool_ = &ForkJoinPool::shared();
+    } else if (threads > 1) {
+      local_pool_.emplace(threads);
+      pool_ = &*local_pool_;
+    }
+    computeHull();
+  }
+
+  // Number of x-slabs the input was cut into.
+  size_t getSlabsNumber() const { return slabs_number_; }
+
+private:
+  struct Key {
+    T x;
+    T y;
+    size_t index;
+
+    bool operator<(const Key &other) const {
+      return x < other.x || (x == other.x && y < other.y);
+    }
+
+    bool sameAs(const Key &other) const {
+      return x == other.x && y == other.y;
+    }
+
+    Point point() const { return {x, y}; }
+  };
+
+  // Lower and upper chain of a hull, both from left to right and sharing
+  // their end points.
+  struct Chains {
+    std::vector<Key> lower;
+    std::vector<Key> upper;
+  };
+
+  ForkJoinPool *pool_ = nullptr;
+  std::optional<ForkJoinPool> local_pool_;
+  size_t slabs_number_ = 0;
+  std::vector<Key> keys_;
+  // slab s is keys_[slab_begin_[s], slab_begin_[s + 1])
+  std::vector<size_t> slab_begin_;
+
+  template <typename A, typename B> void fork(A &&a, B &&b) {
+    if (pool_ == nullptr) {
+      a();
+      b();
+    } else {
+      pool_->invoke(a, b);
+    }
+  }
+
+  template <typename Fn> void forEach(size_t count, size_t grain, Fn &&fn) {
+    if (pool_ == nullptr) {
+      fn(size_t{0}, count);
+    } else {
+      pool_->forEach(count, grain, fn);
+    }
+  }
+
+  void computeHull() {
+    const size_t n = processedSize();
+    hull_indices_.clear();
+    if (n == 0) {
+      materializeHull();
+      return;
+    }
+    cutSlabs();
+    Chains chains = solveSlabs(0, slabs_number_);
+    keys_ = {};
+
+    // lower chain, then the upper one back without its end points
+    for (const Key &key : chains.lower) {
+      hull_indices_.push_back(key.index);
+    }
+    for (size_t i = chains.upper.size(); i-- > 0;) {
+      if (!chains.upper[i].sameAs(chains.lower.front()) &&
+          !chains.upper[i].sameAs(chains.lower.back())) {
+        hull_indices_.push_back(chains.upper[i].index);
+      }
+    }
+    rotateToLowest();
+    materializeHull();
+    assert(hull_.size() <= processedSize());
+  }
+
+  // Buckets the candidates into x-slabs between sampled splitters, with
+  // per-block counts, one prefix sum and a parallel scatter.
+  void cutSlabs() {
+    const size_t n = processedSize();
+    const size_t wanted = std::clamp<size_t>(n / LEAF_SIZE, 1, 4096);
+
+    std::vector<T> splitters;
+    if (wanted > 1) {
+      const size_t samples = wanted * 32;
+      std::vector<T> sample(samples);
+      std::mt19937_64 gen(n);
+      std::uniform_int_distribution<size_t> pick(0, n - 1);
+      for (auto &x : sample) {
+        x = points_[candidate(pick(gen))].x_;
+      }
+      std::sort(sample.begin(), sample.end());
+      for (size_t s = 1; s < wanted; ++s) {
+        splitters.push_back(sample[s * samples / wanted]);
+      }
+      splitters.erase(std::unique(splitters.begin(), splitters.end()),
+                      splitters.end());
+    }
+    // slab s holds splitters[s - 1] < x <= splitters[s]
+    slabs_number_ = splitters.size() + 1;
+    auto slabOf = [&splitters](T x) {
+      return static_cast<size_t>(
+          std::lower_bound(splitters.begin(), splitters.end(), x) -
+          splitters.begin());
+    };
+
+    const size_t block = std::max<size_t>(LEAF_SIZE, n / 256);
+    const size_t blocks = (n + block - 1) / block;
+    std::vector<uint16_t> slab(n);
+    std::vector<size_t> offsets(blocks * slabs_number_);
+    forEach(blocks, 1, [&](size_t first, size_t last) {
+      for (size_t b = first; b < last; ++b) {
+        size_t *count = &offsets[b * slabs_number_];
+        for (size_t k = b * block; k < std::min(n, (b + 1) * block); ++k) {
+          slab[k] = static_cast<uint16_t>(slabOf(points_[candidate(k)].x_));
+          ++count[slab[k]];
+        }
+      }
+    });
+
+    // offsets[b][s] becomes where block b starts writing slab s
+    slab_begin_.assign(slabs_number_ + 1, 0);
+    size_t position = 0;
+    for (size_t s = 0; s < slabs_number_; ++s) {
+      slab_begin_[s] = position;
+      for (size_t b = 0; b < blocks; ++b) {
+        size_t count = offsets[b * slabs_number_ + s];
+        offsets[b * slabs_number_ + s] = position;
+        position += count;
+      }
+    }
+    slab_begin_[slabs_number_] = position;
+
+    keys_.resize(n);
+    forEach(blocks, 1, [&](size_t first, size_t last) {
+      for (size_t b = first; b < last; ++b) {
+        size_t *next = &offsets[b * slabs_number_];
+        for (size_t k = b * block; k < std::min(n, (b + 1) * block); ++k) {
+          const Point &p = points_[candidate(k)];
+          keys_[next[slab[k]]++] = {p.x_, p.y_, candidate(k)};
+        }
+      }
+    });
+  }
+
+  Chains solveSlabs(size_t first, size_t last) {
+    if (last - first == 1) {
+      return solveRange(slab_begin_[first], slab_begin_[first + 1]);
+    }
+    const size_t mid = first + (last - first) / 2;
+    Chains left;
+    Chains right;
+    fork([&] { left = solveSlabs(first, mid); },
+         [&] { right = solveSlabs(mid, last); });
+    return merge(left, right);
+  }
+
+  Chains solveRange(size_t begin, size_t end) {
+    if (end - begin <= LEAF_SIZE) {
+      return leafHull(begin, end);
+    }
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(keys_.begin() + begin, keys_.begin() + mid,
+                     keys_.begin() + end);
+    Chains left;
+    Chains right;
+    fork([&] { left = solveRange(begin, mid); },
+         [&] { right = solveRange(mid, end); });
+    return merge(left, right);
+  }
+
+  // Monotone chain over keys_[begin, end).
+  Chains leafHull(size_t begin, size_t end) {
+    std::sort(keys_.begin() + begin, keys_.begin() + end);
+    Chains chains;
+    auto point = [](const Key &key) { return key.point(); };
+    monotone_chain::buildChain<false, Policy>(
+        keys_.begin() + begin, keys_.begin() + end, chains.lower, point);
+    monotone_chain::buildChain<true, Policy>(
+        keys_.begin() + begin, keys_.begin() + end, chains.upper, point);
+    return chains;
+  }
+
+  // Orientation as seen from inside the chain: positive when (a, b, c)
+  // bends the way a chain vertex must.
+  template <bool Upper>
+  static int turn(const Key &a, const Key &b, const Key &c) {
+    int orientation = Policy::orientation(a.point(), b.point(), c.point());
+    return Upper ? -orientation : orientation;
+  }
+
+  static Chains merge(const Chains &left, const Chains &right) {
+    return {bridge<false>(left.lower, right.lower),
+            bridge<true>(left.upper, right.upper)};
+  }
+
+  // Joins two chains of x-separated hulls, left before right: the bridge
+  // ends are found by dropping vertices from the facing ends until both
+  // ends bend the right way, then the outer parts are concatenated.
+  template <bool Upper>
+  static std::vector<Key> bridge(const std::vector<Key> &left,
+                                 const std::vector<Key> &right) {
+    if (left.empty() || right.empty()) {
+      return left.empty() ? right : left;
+    }
+    size_t i = left.size() - 1;
+    size_t j = 0;
+    // a median split may leave copies of one point on both sides
+    if (right[0].sameAs(left[i])) {
+      if (right.size() == 1) {
+        return left;
+      }
+      j = 1;
+    }
+    bool moved = true;
+    while (moved) {
+      moved = false;
+      while (i > 0 && turn<Upper>(left[i - 1], left[i], right[j]) <= 0) {
+        --i;
+        moved = true;
+      }
+      while (j + 1 < right.size() &&
+             turn<Upper>(left[i], right[j], right[j + 1]) <= 0) {
+        ++j;
+        moved = true;
+      }
+    }
+    std::vector<Key> chain;
+    chain.reserve(i + 1 + right.size() - j);
+    chain.insert(chain.end(), left.begin(), left.begin() + i + 1);
+    chain.insert(chain.end(), right.begin() + j, right.end());
+    return chain;
+  }
+
+  void rotateToLowest() {
+    if (hull_indices_.empty()) {
+      return;
+    }
+    size_t lowest = 0;
+    for (size_t i = 1; i < hull_indices_.size(); ++i) {
+      const Point &p = points_[hull_indices_[i]];
+      const Point &best = points_[hull_indices_[lowest]];
+      if (p.y_ < best.y_ || (p.y_ == best.y_ && p.x_ < best.x_)) {
+        lowest = i;
+      }
+    }
+    std::rotate(hull_indices_.begin(), hull_indices_.begin() + lowest,
+                hull_indices_.end());
+  }
+};
+
+using DivideConquerConvexHull = BasicDivideConquerConvexHull<>;
@@ -1,12 +1,31 @@
 #pragma once
 
-#include "ConvexHullBase.hpp"
+#include "ConvexHullEngine.hpp"
 #include "Point.hpp"
+#include "Predicates.hpp"
+#include "../perf/PhaseCounters.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-class GrahamConvexHull : public ConvexHullBase {
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicGrahamConvexHull : public ConvexHullEngine<T, Policy> {
+  using Base = ConvexHullEngine<T, Policy>;
+  using Point = BasicPoint<T>;
+  using Base::hull_;
+  using Base::hull_indices_;
+  using Base::materializeHull;
+  using Base::points_;
+  using Base::takeCandidates;
+
 public:
+  using Base::processedSize;
+
   class Vector {
   public:
     double x, y;
@@ -14,8 +33,8 @@ public:
     Vector() : x{0}, y{0} {}
 
     Vector(const Point &p1, const Point &p2) {
-      this->x = p2.x_ - p1.x_;
-      this->y = p2.y_ - p1.y_;
+      this->x = static_cast<double>(predicates::difference(p2.x_, p1.x_));
+      this->y = static_cast<double>(predicates::difference(p2.y_, p1.y_));
     }
 
     static double cross(const Vector &v1, const Vector &v2) {
@@ -23,115 +42,153 @@ public:
     }
   };
 
-  GrahamConvexHull(const std::vector<Point> &set) : ConvexHullBase(set) {
+  BasicGrahamConvexHull(std::span<const Point> set,
+                        Prefilter prefilter = Prefilter::NONE)
+      : Base(set, prefilter) {
     computeHull();
   }
 
-  const std::vector<Point> &getHull() const override { return hull_; }
-
-  size_t size() const override { return hull_.size(); }
+  // Hull of set[i] for the i in `subset`.
+  BasicGrahamConvexHull(std::span<const Point> set, std::vector<size_t> subset)
+      : Base(set, std::move(subset)) {
+    computeHull();
+  }
 
 private:
-  void sortPoints(std::vector<Point> &vect, Point centralP) {
-    int j = 0;
-    Point temp;
-    Vector v1;
-    Vector v2;
-
-    for (int i = 1; i < vect.size(); i++) {
-
-      v1 = Vector(centralP, vect[i - 1]);
-      v2 = Vector(centralP, vect[i]);
-
-      j = i;
-      while (j > 0 && Vector::cross(v1, v2) < 0) {
-        temp = vect[j - 1];
-        vect[j - 1] = vect[j];
-        vect[j] = temp;
-        j--;
-
-        if (j > 0) {
-          v1 = Vector(centralP, vect[j - 1]);
-          v2 = Vector(centralP, vect[j]);
-        }
-      }
+  // Sort key of a point around the pivot. `angle` is a pseudo-angle that is
+  // monotone in the polar angle on [0, pi), which covers every point because
+  // the pivot is the lowest (then leftmost) one. It is computed in double
+  // from the coordinate differences, each rounded once (to wide_t<T>, then
+  // to double), so its error is a few units of the coarser of those two
+  // roundings and keys further apart than ANGLE_TOLERANCE are ordered like
+  // the exact angles.
+  struct AngularKey {
+    double angle;
+    Point point;
+    size_t index;
+  };
+
+  static constexpr double DIFFERENCE_EPSILON = [] {
+    using Wide = predicates::wide_t<T>;
+    if constexpr (std::is_floating_point_v<Wide>) {
+      return std::max<double>(std::numeric_limits<Wide>::epsilon() / 2,
+                              predicates::EPSILON);
+    } else {
+      return predicates::EPSILON;
     }
+  }();
+  static constexpr double ANGLE_TOLERANCE = 16 * DIFFERENCE_EPSILON;
+
+  static double pseudoAngle(const Point &centralP, const Point &p) {
+    double dx = static_cast<double>(predicates::difference(p.x_, centralP.x_));
+    double dy = static_cast<double>(predicates::difference(p.y_, centralP.y_));
+    return -dx / (std::abs(dx) + dy);
   }
 
-  void computeHull() override {
-    Point lowestP = points_[0];
-    Point currP;
+  // Exact angular order around centralP; points on the same ray go nearest
+  // first, by their offsets which are monotone along the ray.
+  static bool angularLess(const Point &centralP, const AngularKey &a,
+                          const AngularKey &b) {
+    int turn = Policy::orientation(centralP, a.point, b.point);
+    if (turn != 0) {
+      return turn > 0;
+    }
+    auto offset = [](T from, T to) {
+      auto d = predicates::difference(to, from);
+      return d < 0 ? -d : d;
+    };
+    auto adx = offset(centralP.x_, a.point.x_);
+    auto bdx = offset(centralP.x_, b.point.x_);
+    if (adx != bdx) {
+      return adx < bdx;
+    }
+    return offset(centralP.y_, a.point.y_) < offset(centralP.y_, b.point.y_);
+  }
+
+  // Orders point indices counter-clockwise around centralP. Points collinear
+  // with the pivot go nearest first, so the scan drops all but the farthest.
+  // Only keys within the tolerance of each other need the exact test, so
+  // the comparator is the exact order and std::sort stays O(n log n).
+  void sortPoints(std::vector<size_t> &vect, Point centralP) {
+    std::vector<AngularKey> keys;
+    keys.reserve(vect.size());
+    for (size_t idx : vect) {
+      const Point &p = points_[idx];
+      keys.push_back({pseudoAngle(centralP, p), p, idx});
+    }
 
-    for (int i = 1; i < points_.size(); i++) {
-      currP = points_[i];
+    std::sort(keys.begin(), keys.end(),
+              [&centralP](const AngularKey &a, const AngularKey &b) {
+                if (std::abs(a.angle - b.angle) > ANGLE_TOLERANCE) {
+                  return a.angle < b.angle;
+                }
+                return angularLess(centralP, a, b);
+              });
 
+    for (size_t i = 0; i < keys.size(); ++i) {
+      vect[i] = keys[i].index;
+    }
+  }
+
+  void computeHull() {
+    std::vector<size_t> candidates = takeCandidates();
+    hull_indices_.clear();
+    if (candidates.empty()) {
+      materializeHull();
+      return;
+    }
+
+    perf::Phase sort("sort");
+    size_t lowest = candidates[0];
+    for (size_t idx : candidates) {
+      const Point &currP = points_[idx];
+      const Point &lowestP = points_[lowest];
       if (lowestP.y_ > currP.y_ ||
           (lowestP.y_ == currP.y_ && lowestP.x_ > currP.x_)) {
-        lowestP = currP;
+        lowest = idx;
       }
     }
+    const Point lowestP = points_[lowest];
 
-    std::vector<Point> vc;
-
-    for (int i = 0; i < points_.size(); i++) {
-      if (points_[i] != lowestP) {
-        vc.push_back(points_[i]);
+    // drop the pivot and its duplicates in place
+    size_t kept = 0;
+    for (size_t idx : candidates) {
+      if (points_[idx] != lowestP) {
+        candidates[kept++] = idx;
       }
     }
-
-    sortPoints(vc, lowestP);
-
-    std::vector<Point> result;
-
-    result.push_back(lowestP);
-    result.push_back(vc[0]);
-
-    Vector v1; // вектор который связывает точку предпоследнюю в стеке и
-               // нынешнюю точку в итерации
-    Vector v2; // вектор который связывает точку предпоследнюю и последнюю точку
-               // в стеке
-    Point p1;  // предпоследняя точка
-    Point p2;  // последняя точка
-    Point p3;  // нынешняя точка в итерации
-
-    for (int i = 1; i < vc.size(); i++) {
-      p3 = vc[i];
-
-      p2 = result.back();
-      result.pop_back();
-      p1 = result.back();
-
-      v1 = Vector(p1, p3);
-      v2 = Vector(p1, p2);
-
-      int j = i;
-      while (Vector::cross(v2, v1) < 0) {
-        // std::cout << "deleted point: " << std::endl
-        //           << "x:" << p2.x_ << std::endl
-        //           << "y: " << p2.y_ << std::endl;
-        result.push_back(p3);
-
-        p3 = result.back();
-        result.pop_back();
-
-        p2 = result.back();
+    candidates.resize(kept);
+
+    sortPoints(candidates, lowestP);
+    sort.end();
+
+    perf::Phase scan("scan");
+    std::vector<size_t> &result = hull_indices_;
+    result.push_back(lowest);
+
+    // Pop while the last two points in the stack and the current one do not
+    // make a left turn, so collinear points never end up in the hull.
+    for (size_t idx : candidates) {
+      const Point &p3 = points_[idx];
+      while (result.size() >= 2) {
+        const Point &p1 = points_[result[result.size() - 2]]; // предпоследняя
+        const Point &p2 = points_[result.back()];             // последняя
+        if (Policy::orientation(p1, p2, p3) > 0) {
+          break;
+        }
+        TRACE_COUNT(GRAHAM_POPS, 1);
         result.pop_back();
-
-        p1 = result.back();
-
-        v1 = Vector(p1, p3);
-        v2 = Vector(p1, p2);
       }
-
-      result.push_back(p2);
-      result.push_back(p3);
+      result.push_back(idx);
     }
 
-    this->hull_ = result;
-    assert(hull_.size() <= points_.size());
+    materializeHull();
+    assert(hull_.size() <= processedSize());
   }
 };
 
+using GrahamConvexHull = BasicGrahamConvexHull<>;
+
 // points.push_back(Point(3, 2));
 // points.push_back(Point(2, 6));
 // points.push_back(Point(5, 5));
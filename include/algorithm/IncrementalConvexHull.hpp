@@ -0,0 +1,277 @@
+#pragma once
+
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <span>
+#include <vector>
+
+// Online convex hull of a stream of points, insert only. The lower and
+// upper chains are kept in ordered maps keyed by x, so a new point is
+// located on each chain in O(log h); a point on or inside both chains is
+// rejected right there, otherwise it is linked in and the neighbours it
+// hides are spliced out, O(log h) amortized per insert.
+//
+// The hull is reported like the other engines: counter-clockwise from the
+// lowest (then leftmost) vertex, without collinear or duplicate points,
+// with indices in insertion order.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicIncrementalConvexHull {
+public:
+  using coordinate_type = T;
+  using point_type = BasicPoint<T>;
+
+  BasicIncrementalConvexHull() = default;
+
+  explicit BasicIncrementalConvexHull(std::span<const point_type> points) {
+    for (const auto &point : points) {
+      insert(point);
+    }
+  }
+
+  // Adds the next point of the stream, it gets index insertedSize() - 1.
+  // Returns whether the hull changed.
+  bool insert(const point_type &point) { return insert(point, inserted_); }
+
+  // Same, with an index chosen by the caller.
+  bool insert(const point_type &point, size_t index) {
+    ++inserted_;
+    if (undoable_) {
+      journal_.push_back({erased_.size(), {}, {}});
+    }
+    bool lower = insertInto<false>(lower_, point, index);
+    bool upper = insertInto<true>(upper_, point, index);
+    if (lower || upper) {
+      dirty_ = true;
+    }
+    return lower || upper;
+  }
+
+  // Keeps what each insert changes from now on, so that undo() can revert
+  // the inserts in reverse order.
+  void enableUndo() { undoable_ = true; }
+
+  // Reverts the latest insert that has not been undone yet; costs what the
+  // insert did.
+  void undo() {
+    const Change change = journal_.back();
+    journal_.pop_back();
+    --inserted_;
+    revert(upper_, change.upper);
+    revert(lower_, change.lower);
+    if (change.upper.added || change.lower.added) {
+      dirty_ = true;
+    }
+    for (size_t i = erased_.size(); i > change.erased_begin; --i) {
+      const Erased &erased = erased_[i - 1];
+      (erased.upper ? upper_ : lower_).emplace(erased.x, erased.vertex);
+    }
+    erased_.resize(change.erased_begin);
+  }
+
+  // Calls fn(point, index) for the vertices of the lower (upper) chain from
+  // left to right.
+  template <typename Fn> void visitLowerChain(Fn &&fn) const {
+    for (auto it = lower_.begin(); it != lower_.end(); ++it) {
+      fn(at(it), it->second.index);
+    }
+  }
+
+  template <typename Fn> void visitUpperChain(Fn &&fn) const {
+    for (auto it = upper_.begin(); it != upper_.end(); ++it) {
+      fn(at(it), it->second.index);
+    }
+  }
+
+  // Whether the point is inside or on the boundary of the current hull.
+  bool contains(const point_type &point) const {
+    return !outside<false>(lower_, point) && !outside<true>(upper_, point);
+  }
+
+  const std::vector<point_type> &getHull() const {
+    refresh();
+    return hull_;
+  }
+
+  // Hull vertices as insertion indices, in the order of getHull().
+  const std::vector<size_t> &getHullIndices() const {
+    refresh();
+    return hull_indices_;
+  }
+
+  size_t size() const { return getHull().size(); }
+
+  size_t insertedSize() const { return inserted_; }
+
+private:
+  struct Vertex {
+    T y;
+    size_t index;
+  };
+
+  // x -> vertex, left to right. The lower chain turns left at every
+  // vertex, the upper chain turns right.
+  using chain_t = std::map<T, Vertex>;
+
+  chain_t lower_;
+  chain_t upper_;
+  size_t inserted_ = 0;
+
+  // undo log: what one insert did to one chain
+  struct ChainChange {
+    bool added = false;
+    T x{};
+    // vertex that was at x before, if any
+    bool replaced = false;
+    Vertex previous{};
+  };
+  struct Change {
+    // the insert's erased vertices are erased_[erased_begin, ...)
+    size_t erased_begin;
+    ChainChange lower;
+    ChainChange upper;
+  };
+  struct Erased {
+    bool upper;
+    T x;
+    Vertex vertex;
+  };
+  bool undoable_ = false;
+  std::vector<Change> journal_;
+  std::vector<Erased> erased_;
+
+  mutable bool dirty_ = false;
+  mutable std::vector<point_type> hull_;
+  mutable std::vector<size_t> hull_indices_;
+
+  static point_type at(typename chain_t::const_iterator it) {
+    return {it->first, it->second.y};
+  }
+
+  // Orientation as seen from inside the chain: positive when (a, b, c)
+  // bends the way a chain vertex must.
+  template <bool Upper>
+  static int turn(const point_type &a, const point_type &b,
+                  const point_type &c) {
+    int orientation = Policy::orientation(a, b, c);
+    return Upper ? -orientation : orientation;
+  }
+
+  // Whether y is strictly beyond the chain vertex y0 at the same x.
+  template <bool Upper> static bool beyond(T y, T y0) {
+    return Upper ? y > y0 : y < y0;
+  }
+
+  // Whether the point is strictly outside the half of the plane bounded by
+  // the chain: below the lower one, above the upper one, or past its ends.
+  template <bool Upper>
+  static bool outside(const chain_t &chain, const point_type &point) {
+    if (chain.empty()) {
+      return true;
+    }
+    auto next = chain.lower_bound(point.x_);
+    if (next != chain.end() && next->first == point.x_) {
+      return beyond<Upper>(point.y_, next->second.y);
+    }
+    if (next == chain.begin() || next == chain.end()) {
+      return true;
+    }
+    auto prev = std::prev(next);
+    return turn<Upper>(at(prev), at(next), point) < 0;
+  }
+
+  template <bool Upper>
+  bool insertInto(chain_t &chain, const point_type &point, size_t index) {
+    if (!outside<Upper>(chain, point)) {
+      return false;
+    }
+    auto [it, added] = chain.try_emplace(point.x_, Vertex{point.y_, index});
+    if (undoable_) {
+      ChainChange &change =
+          Upper ? journal_.back().upper : journal_.back().lower;
+      change.added = true;
+      change.x = point.x_;
+      change.replaced = !added;
+      change.previous = it->second;
+    }
+    it->second = Vertex{point.y_, index};
+
+    // splice out the vertices that no longer bend the right way
+    while (it != chain.begin()) {
+      auto prev = std::prev(it);
+      if (prev == chain.begin() ||
+          turn<Upper>(at(std::prev(prev)), at(prev), point) > 0) {
+        break;
+      }
+      erase<Upper>(chain, prev);
+    }
+    while (true) {
+      auto next = std::next(it);
+      if (next == chain.end() || std::next(next) == chain.end() ||
+          turn<Upper>(point, at(next), at(std::next(next))) > 0) {
+        break;
+      }
+      erase<Upper>(chain, next);
+    }
+    return true;
+  }
+
+  template <bool Upper>
+  void erase(chain_t &chain, typename chain_t::iterator it) {
+    if (undoable_) {
+      erased_.push_back({Upper, it->first, it->second});
+    }
+    chain.erase(it);
+  }
+
+  static void revert(chain_t &chain, const ChainChange &change) {
+    if (!change.added) {
+      return;
+    }
+    if (change.replaced) {
+      chain[change.x] = change.previous;
+    } else {
+      chain.erase(change.x);
+    }
+  }
+
+  // Lower chain left to right, then the upper chain back, each end shared
+  // by both chains listed once.
+  void refresh() const {
+    if (!dirty_) {
+      return;
+    }
+    dirty_ = false;
+    hull_.clear();
+    hull_indices_.clear();
+    auto push = [this](const point_type &point, size_t index) {
+      if (!hull_.empty() && (hull_.back() == point || hull_[0] == point)) {
+        return;
+      }
+      hull_.push_back(point);
+      hull_indices_.push_back(index);
+    };
+    for (auto it = lower_.begin(); it != lower_.end(); ++it) {
+      push(at(it), it->second.index);
+    }
+    for (auto it = upper_.rbegin(); it != upper_.rend(); ++it) {
+      push({it->first, it->second.y}, it->second.index);
+    }
+
+    size_t lowest = 0;
+    for (size_t i = 1; i < hull_.size(); ++i) {
+      if (hull_[i].y_ < hull_[lowest].y_ ||
+          (hull_[i].y_ == hull_[lowest].y_ && hull_[i].x_ < hull_[lowest].x_)) {
+        lowest = i;
+      }
+    }
+    std::rotate(hull_.begin(), hull_.begin() + lowest, hull_.end());
+    std::rotate(hull_indices_.begin(), hull_indices_.begin() + lowest,
+                hull_indices_.end());
+  }
+};
+
+using IncrementalConvexHull = BasicIncrementalConvexHull<>;
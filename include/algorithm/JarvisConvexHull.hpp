@@ -1,78 +1,198 @@
 #pragma once
 
-#include "ConvexHullBase.hpp"
+#include "../simd/Orientation.hpp"
+#include "ConvexHullEngine.hpp"
 #include "Point.hpp"
+#include "PointSet.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
 #include <cassert>
+#include <span>
+#include <type_traits>
 #include <vector>
 
-class JarvisConvexHull : public ConvexHullBase {
+// Double coordinates are tested in batches with the SIMD orientation
+// kernel, other coordinate types one point at a time.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicJarvisConvexHull : public ConvexHullEngine<T, Policy> {
+  using Base = ConvexHullEngine<T, Policy>;
+  using Point = BasicPoint<T>;
+  using Base::candidate;
+  using Base::candidatesNumber;
+  using Base::hull_;
+  using Base::hull_indices_;
+  using Base::materializeHull;
+  using Base::points_;
+
+  static constexpr bool BATCHED = std::is_same_v<T, double>;
+
 public:
-  JarvisConvexHull(const std::vector<Point> &points) : ConvexHullBase(points) {
+  using Base::processedSize;
+
+  BasicJarvisConvexHull(std::span<const Point> points,
+                        Prefilter prefilter = Prefilter::NONE)
+      : Base(points, prefilter) {
     computeHull();
   }
 
-  const std::vector<Point> &getHull() const override { return hull_; }
-
-  size_t size() const override { return hull_size_; }
+  // Reads the x/y columns directly when the set is in SoA mode.
+  BasicJarvisConvexHull(const PointSet &set,
+                        Prefilter prefilter = Prefilter::NONE)
+    requires BATCHED
+      : Base(set.get_set(), prefilter) {
+    if (set.has_soa() && prefilter == Prefilter::NONE) {
+      coords_ = set.coords();
+    }
+    computeHull();
+  }
 
 private:
-  size_t hull_size_;
+  // points per orientation batch, the crosses stay in L1
+  static constexpr size_t BLOCK_SIZE = 256;
 
-  void computeHull() override {
-    const size_t points_number = points_.size();
+  // coordinates of the candidates, k-th candidate at coords_[k]
+  CoordView coords_;
+  // same for the coordinate types without a batch kernel
+  const Point *data_ = nullptr;
+  // survivors of the pre-filter packed together
+  std::vector<Point> packed_;
+  Point min_;
+  Point max_;
+
+  Point point(size_t k) const {
+    if constexpr (BATCHED) {
+      return coords_[k];
+    } else {
+      return data_[k];
+    }
+  }
+
+  void computeHull() {
+    const size_t points_number = candidatesNumber();
+    hull_indices_.clear();
     if (points_number < 3) {
-      hull_ = points_;
-      hull_size_ = points_number;
+      for (size_t k = 0; k < points_number; ++k) {
+        hull_indices_.push_back(candidate(k));
+      }
+      materializeHull();
       return;
     }
+    if (coords_.x == nullptr) {
+      packCoords();
+    }
 
     size_t leftmost = get_entry_point_idx();
     size_t current = leftmost;
-    hull_.clear();
+    const Point start_point = point(leftmost);
+    if constexpr (BATCHED) {
+      findBounds();
+    }
     do {
-      hull_.push_back(points_[current]);
-      size_t next = (current + 1) % points_number;
+      hull_indices_.push_back(candidate(current));
+      current = nextOnHull(current);
+      // compare coordinates, the march may come back on a duplicate
+    } while (point(current) != start_point);
+    materializeHull();
+    assert(hull_[0] == point(leftmost));
+    assert(hull_.size() <= points_number);
+  }
+
+  // The candidate that has every other one left of (current, it).
+  size_t nextOnHull(size_t current) const {
+    const size_t points_number = candidatesNumber();
+    size_t next = (current + 1) % points_number;
+    const Point current_point = point(current);
+    Point next_point = point(next);
+    if constexpr (!BATCHED) {
       for (size_t i = 0; i < points_number; ++i) {
-        if (jarvis_compare(points_[i], points_[next], points_[current])) {
+        if (jarvis_compare(point(i), next_point, current_point)) {
           next = i;
+          next_point = point(i);
         }
       }
-      current = next;
-    } while (current != leftmost);
-    hull_size_ = hull_.size();
-    assert(hull_[0] == points_[leftmost]);
-    assert(hull_.size() <= points_.size());
+      return next;
+    } else {
+      double crosses[BLOCK_SIZE];
+      const double span_x = std::max(std::abs(max_.x_ - current_point.x_),
+                                     std::abs(min_.x_ - current_point.x_));
+      const double span_y = std::max(std::abs(max_.y_ - current_point.y_),
+                                     std::abs(min_.y_ - current_point.y_));
+      double bound = predicates::crossErrorBound(current_point, next_point,
+                                                 span_x, span_y);
+      for (size_t begin = 0; begin < points_number; begin += BLOCK_SIZE) {
+        size_t end = std::min(begin + BLOCK_SIZE, points_number);
+        simd::orientationBatch(coords_, begin, end, current_point, next_point,
+                               crosses);
+        for (size_t i = begin; i < end; ++i) {
+          // a cross product above the error bound is certainly a left turn,
+          // anything else goes to the exact comparison
+          if (crosses[i - begin] > bound ||
+              !jarvis_compare(point(i), next_point, current_point)) {
+            continue;
+          }
+          next = i;
+          next_point = point(i);
+          bound = predicates::crossErrorBound(current_point, next_point,
+                                              span_x, span_y);
+          simd::orientationBatch(coords_, i + 1, end, current_point,
+                                 next_point, crosses + (i + 1 - begin));
+        }
+      }
+      return next;
+    }
   }
 
-  size_t get_entry_point_idx() {
-    size_t entry_point_idx = 0;
-    for (size_t i = 1; i != points_.size(); ++i) {
-      bool y_less = (points_[i].y_ < points_[entry_point_idx].y_);
-      bool x_less = (points_[i].x_ < points_[entry_point_idx].x_);
-      bool y_eq = (std::abs(points_[i].y_ - points_[entry_point_idx].y_) < EPS);
-      if (y_less || (y_eq && x_less))
-        entry_point_idx = i;
+  // The march reads the input in place; only a pre-filtered subset is
+  // copied, and it is small.
+  void packCoords() {
+    const Point *data = points_.data();
+    if (processedSize() != points_.size()) {
+      packed_.reserve(processedSize());
+      for (size_t k = 0; k < processedSize(); ++k) {
+        packed_.push_back(points_[candidate(k)]);
+      }
+      data = packed_.data();
+    }
+    if constexpr (BATCHED) {
+      coords_ = CoordView(data);
+    } else {
+      data_ = data;
     }
-    return entry_point_idx;
   }
 
-  bool jarvis_compare(const Point &candidate, const Point &current_candidate,
-                      const Point &current_point) {
-    double cross = cross_product(current_point, current_candidate, candidate);
-    if (std::abs(cross) < EPS) {
-      return (distance_squared(current_point, candidate) >
-              distance_squared(current_point, current_candidate));
+  // Bounding box of the candidates, for the error bound of the batch.
+  void findBounds() {
+    min_ = max_ = point(0);
+    for (size_t i = 1; i < candidatesNumber(); ++i) {
+      const Point p = point(i);
+      min_.x_ = std::min(min_.x_, p.x_);
+      min_.y_ = std::min(min_.y_, p.y_);
+      max_.x_ = std::max(max_.x_, p.x_);
+      max_.y_ = std::max(max_.y_, p.y_);
     }
-    return cross < 0;
   }
 
-  double cross_product(const Point &a, const Point &b, const Point &c) {
-    return (b.x_ - a.x_) * (c.y_ - a.y_) - (b.y_ - a.y_) * (c.x_ - a.x_);
+  size_t get_entry_point_idx() const {
+    size_t entry_point_idx = 0;
+    for (size_t i = 1; i != candidatesNumber(); ++i) {
+      bool y_less = (point(i).y_ < point(entry_point_idx).y_);
+      bool x_less = (point(i).x_ < point(entry_point_idx).x_);
+      bool y_eq = (point(i).y_ == point(entry_point_idx).y_);
+      if (y_less || (y_eq && x_less))
+        entry_point_idx = i;
+    }
+    return entry_point_idx;
   }
 
-  double distance_squared(const Point &a, const Point &b) {
-    double dx = a.x_ - b.x_;
-    double dy = a.y_ - b.y_;
-    return dx * dx + dy * dy;
+  static bool jarvis_compare(const Point &candidate,
+                             const Point &current_candidate,
+                             const Point &current_point) {
+    int turn = Policy::orientation(current_point, current_candidate, candidate);
+    if (turn == 0) {
+      return Policy::closer(current_point, current_candidate, candidate);
+    }
+    return turn < 0;
   }
 };
+
+using JarvisConvexHull = BasicJarvisConvexHull<>;
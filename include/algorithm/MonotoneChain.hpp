@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Point.hpp"
+#include <cstddef>
+
+// The chain building of Andrew's monotone chain, for the engines that run
+// it on their own keys. `point(key)` gives a key's BasicPoint, and
+// Policy::orientation is the orientation test.
+namespace monotone_chain {
+
+// Appends to `chain` the lower (or upper) chain of the keys [first, last),
+// sorted by (x, y), from left to right: every vertex turns left (right
+// for the upper chain), so collinear points are dropped. Of equal points
+// that follow each other the first one is kept.
+template <bool Upper, typename Policy, typename It, typename Chain,
+          typename PointOf>
+void buildChain(It first, It last, Chain &chain, PointOf &&point) {
+  for (; first != last; ++first) {
+    if (!chain.empty() && point(chain.back()) == point(*first)) {
+      continue;
+    }
+    while (chain.size() >= 2) {
+      const int turn = Policy::orientation(point(chain[chain.size() - 2]),
+                                           point(chain.back()), point(*first));
+      if ((Upper ? -turn : turn) > 0) {
+        break;
+      }
+      chain.pop_back();
+    }
+    chain.push_back(*first);
+  }
+}
+
+// The hull of the keys [first, last), sorted by (x, y), into `hull`
+// counter-clockwise from the leftmost (then lowest) key; `upper` is
+// scratch for the upper chain.
+template <typename Policy, typename It, typename Chain, typename PointOf>
+void buildHull(It first, It last, Chain &hull, Chain &upper,
+               PointOf &&point) {
+  hull.clear();
+  upper.clear();
+  buildChain<false, Policy>(first, last, hull, point);
+  buildChain<true, Policy>(first, last, upper, point);
+  // the upper chain right to left, without the end points it shares
+  for (size_t i = upper.size(); i > 2; --i) {
+    hull.push_back(upper[i - 2]);
+  }
+}
+
+} // namespace monotone_chain
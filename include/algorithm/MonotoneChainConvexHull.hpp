@@ -0,0 +1,123 @@
+#pragma once
+
+#include "ConvexHullEngine.hpp"
+#include "MonotoneChain.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <cassert>
+#include <ranges>
+#include <span>
+#include <vector>
+
+// Andrew's monotone chain. Points are sorted by (x, y) and split into
+// separate x[] and y[] columns, then the lower and upper chains are built
+// over those columns by the shared monotone chain (MonotoneChain.hpp).
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicMonotoneChainConvexHull : public ConvexHullEngine<T, Policy> {
+  using Base = ConvexHullEngine<T, Policy>;
+  using Point = BasicPoint<T>;
+  using Base::candidate;
+  using Base::hull_;
+  using Base::hull_indices_;
+  using Base::materializeHull;
+  using Base::points_;
+
+public:
+  using Base::processedSize;
+
+  BasicMonotoneChainConvexHull(std::span<const Point> points,
+                               Prefilter prefilter = Prefilter::NONE)
+      : Base(points, prefilter) {
+    computeHull();
+  }
+
+private:
+  std::vector<T> xs_;
+  std::vector<T> ys_;
+  // input index of each column entry
+  std::vector<size_t> ids_;
+
+  void computeHull() {
+    sortColumns();
+    const size_t n = xs_.size();
+    hull_indices_.clear();
+    if (n < 3) {
+      hull_indices_ = ids_;
+      rotateToLowest();
+      materializeHull();
+      return;
+    }
+
+    // indices into the columns, counter-clockwise from the leftmost one
+    std::vector<size_t> chain;
+    std::vector<size_t> upper;
+    const auto columns = std::views::iota(size_t{0}, n);
+    monotone_chain::buildHull<Policy>(
+        columns.begin(), columns.end(), chain, upper,
+        [this](size_t i) { return Point{xs_[i], ys_[i]}; });
+
+    hull_indices_.reserve(chain.size());
+    for (size_t i : chain) {
+      hull_indices_.push_back(ids_[i]);
+    }
+    rotateToLowest();
+    materializeHull();
+    assert(hull_.size() <= processedSize());
+  }
+
+  struct LexKey {
+    T x;
+    T y;
+    size_t index;
+  };
+
+  // Sorts the input lexicographically, drops duplicates and stores the
+  // result column-wise.
+  void sortColumns() {
+    std::vector<LexKey> sorted;
+    sorted.reserve(processedSize());
+    for (size_t k = 0; k < processedSize(); ++k) {
+      const Point &p = points_[candidate(k)];
+      sorted.push_back({p.x_, p.y_, candidate(k)});
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const LexKey &a, const LexKey &b) {
+                return a.x < b.x || (a.x == b.x && a.y < b.y);
+              });
+    sorted.erase(std::unique(sorted.begin(), sorted.end(),
+                             [](const LexKey &a, const LexKey &b) {
+                               return a.x == b.x && a.y == b.y;
+                             }),
+                 sorted.end());
+
+    xs_.resize(sorted.size());
+    ys_.resize(sorted.size());
+    ids_.resize(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+      xs_[i] = sorted[i].x;
+      ys_[i] = sorted[i].y;
+      ids_[i] = sorted[i].index;
+    }
+  }
+
+  // The other engines start the counter-clockwise hull at the lowest (then
+  // leftmost) point, the chains start at the leftmost one.
+  void rotateToLowest() {
+    if (hull_indices_.empty()) {
+      return;
+    }
+    size_t lowest = 0;
+    for (size_t i = 1; i < hull_indices_.size(); ++i) {
+      const Point &p = points_[hull_indices_[i]];
+      const Point &best = points_[hull_indices_[lowest]];
+      if (p.y_ < best.y_ || (p.y_ == best.y_ && p.x_ < best.x_)) {
+        lowest = i;
+      }
+    }
+    std::rotate(hull_indices_.begin(), hull_indices_.begin() + lowest,
+                hull_indices_.end());
+  }
+};
+
+using MonotoneChainConvexHull = BasicMonotoneChainConvexHull<>;
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "../io/MappedPointFile.hpp"
+#include "../io/PointFile.hpp"
+#include "AklToussaintFilter.hpp"
+#include "MonotoneChainConvexHull.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// Hull of more points than fit in memory. The input is read in chunks of
+// a fixed number of points; each chunk's hull is found with the monotone
+// chain (after the Akl–Toussaint filter) and merged into a running hull,
+// which is all that is kept between chunks. Memory stays O(chunk + h)
+// whatever the number of points; a mapped file also gives back the pages
+// of every finished chunk.
+//
+// The hull is reported like the other engines, indices count the points
+// of all the add() calls from 0.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicOutOfCoreConvexHull {
+public:
+  using coordinate_type = T;
+  using point_type = BasicPoint<T>;
+
+  static constexpr size_t DEFAULT_CHUNK_SIZE = size_t{1} << 20;
+
+  explicit BasicOutOfCoreConvexHull(size_t chunk_size = DEFAULT_CHUNK_SIZE)
+      : chunk_size_{chunk_size} {
+    if (chunk_size == 0) {
+      throw std::invalid_argument("Chunk size must be positive!");
+    }
+  }
+
+  // Points already in memory, or mapped by the caller.
+  void add(std::span<const point_type> points) {
+    for (size_t begin = 0; begin < points.size(); begin += chunk_size_) {
+      size_t end = std::min(begin + chunk_size_, points.size());
+      mergeChunk(points.subspan(begin, end - begin));
+    }
+  }
+
+  void add(const BasicMappedPointFile<T> &file) {
+    std::span<const point_type> points = file.points();
+    for (size_t begin = 0; begin < points.size(); begin += chunk_size_) {
+      size_t end = std::min(begin + chunk_size_, points.size());
+      mergeChunk(points.subspan(begin, end - begin));
+      file.release(begin, end);
+    }
+  }
+
+  // A columnar file of any coordinate type; each chunk is converted to T.
+  void add(const PointFile &file) {
+    for (size_t begin = 0; begin < file.size(); begin += chunk_size_) {
+      size_t end = std::min(begin + chunk_size_, file.size());
+      std::vector<point_type> chunk = file.toPoints<T>(begin, end);
+      mergeChunk(chunk);
+      file.release(begin, end);
+    }
+  }
+
+  const std::vector<point_type> &getHull() const { return hull_; }
+
+  const std::vector<size_t> &getHullIndices() const { return hull_indices_; }
+
+  size_t size() const { return hull_.size(); }
+
+  // Points read so far.
+  size_t processedSize() const { return processed_; }
+
+  size_t chunksNumber() const { return chunks_; }
+
+private:
+  using engine_t = BasicMonotoneChainConvexHull<T, Policy>;
+
+  size_t chunk_size_;
+  size_t processed_ = 0;
+  size_t chunks_ = 0;
+  std::vector<point_type> hull_;
+  std::vector<size_t> hull_indices_;
+
+  void mergeChunk(std::span<const point_type> chunk) {
+    engine_t chunk_hull(chunk, Prefilter::OCTAGON);
+
+    // the running hull and the chunk's hull together are O(h) points
+    std::vector<point_type> candidates = hull_;
+    std::vector<size_t> indices = hull_indices_;
+    for (size_t idx : chunk_hull.getHullIndices()) {
+      candidates.push_back(chunk[idx]);
+      indices.push_back(processed_ + idx);
+    }
+    engine_t merged(candidates);
+    hull_ = merged.getHull();
+    hull_indices_.clear();
+    for (size_t idx : merged.getHullIndices()) {
+      hull_indices_.push_back(indices[idx]);
+    }
+    processed_ += chunk.size();
+    ++chunks_;
+  }
+};
+
+using OutOfCoreConvexHull = BasicOutOfCoreConvexHull<>;
@@ -3,29 +3,34 @@
 #include "../Constants.hpp"
 #include <iostream>
 
-struct Point {
-  double x_;
-  double y_;
+// A point with coordinates of type T: float, double, int32_t or int64_t.
+template <typename T> struct BasicPoint {
+  using coordinate_type = T;
 
-  Point() : x_{0.0}, y_{0.0} {}
+  T x_;
+  T y_;
 
-  Point(double x, double y) : x_{x}, y_{y} {}
+  BasicPoint() : x_{0}, y_{0} {}
+
+  BasicPoint(T x, T y) : x_{x}, y_{y} {}
 
   void display_log() const {
     std::cout << "Point : (" << x_ << ", " << y_ << ")";
   }
 
-  bool operator==(const Point &other) const {
-    return std::abs(x_ - other.x_) < EPS && std::abs(y_ - other.y_) < EPS;
+  bool operator==(const BasicPoint &other) const {
+    return x_ == other.x_ && y_ == other.y_;
   }
 
-  bool operator!=(const Point &other) const { return !(*this == other); }
+  bool operator!=(const BasicPoint &other) const { return !(*this == other); }
 
-  Point operator+(const Point &other) const noexcept {
-    return Point(x_ + other.x_, y_ + other.y_);
+  BasicPoint operator+(const BasicPoint &other) const noexcept {
+    return BasicPoint(x_ + other.x_, y_ + other.y_);
   }
 
-  Point operator-(const Point &other) const noexcept {
-    return Point(x_ - other.x_, y_ - other.y_);
+  BasicPoint operator-(const BasicPoint &other) const noexcept {
+    return BasicPoint(x_ - other.x_, y_ - other.y_);
   }
 };
+
+using Point = BasicPoint<double>;
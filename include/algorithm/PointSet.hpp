@@ -1,17 +1,23 @@
 #pragma once
 
+#include "../io/CsvPoints.hpp"
+#include "../io/PointFile.hpp"
+#include "../simd/AlignedAllocator.hpp"
+#include "../simd/Orientation.hpp"
 #include "Point.hpp"
+#include <algorithm>
 #include <random>
+#include <string>
 #include <vector>
 
 class PointSet {
 public:
   PointSet() = default;
 
-  PointSet(const std::vector<Point> &set)
+  explicit PointSet(const std::vector<Point> &set)
       : set_{set} { /* check_set_size(); */ }
 
-  PointSet(std::vector<Point> &&set) : set_{std::move(set)} {
+  explicit PointSet(std::vector<Point> &&set) : set_{std::move(set)} {
     /* check_set_size(); */
   }
 
@@ -20,6 +26,34 @@ public:
       point.x_ += x;
       point.y_ += y;
     }
+    sync_soa();
+  }
+
+  // Structure-of-arrays mode: keeps x and y in two 64-byte aligned columns
+  // next to the points, updated whenever the set changes.
+  void enable_soa() {
+    soa_ = true;
+    sync_soa();
+  }
+
+  void disable_soa() {
+    soa_ = false;
+    xs_ = {};
+    ys_ = {};
+  }
+
+  bool has_soa() const { return soa_; }
+
+  const double *xs() const { return xs_.data(); }
+
+  const double *ys() const { return ys_.data(); }
+
+  // The x/y columns in SoA mode, the points themselves otherwise.
+  CoordView coords() const {
+    if (soa_) {
+      return {xs_.data(), ys_.data()};
+    }
+    return CoordView(set_.data());
   }
 
   void display_log() const {
@@ -29,7 +63,7 @@ public:
     }
   }
 
-  const std::vector<Point> &get_set() { return set_; }
+  const std::vector<Point> &get_set() const { return set_; }
 
   size_t size() const { return set_.size(); }
 
@@ -67,6 +101,7 @@ public:
     for (size_t i = 0; i != size; ++i) {
       set_.emplace_back(x_dist(gen), y_dist(gen));
     }
+    sync_soa();
   }
 
   void generate_circular_points(size_t size) {
@@ -82,13 +117,89 @@ public:
       double y = sin(angle);
       set_.emplace_back(x, y);
     }
+    sync_soa();
+  }
+
+  // Reads a point file, or a CSV file if it isn't one; coordinates of any
+  // type are converted to double.
+  void load(const std::string &path) {
+    if (PointFile::isPointFile(path)) {
+      set_ = PointFile{path}.toPoints();
+    } else {
+      set_ = csv::read(path);
+    }
+    sync_soa();
+  }
+
+  // Writes the set as CSV if the path ends in ".csv", as a point file
+  // otherwise.
+  void save(const std::string &path) const {
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+      csv::write<double>(path, set_);
+    } else {
+      writePointFile<double>(path, set_);
+    }
+  }
+
+  // Scales and moves the set, keeping its aspect ratio, so that it fills
+  // the window inside the padding.
+  void fit_into(double width = SF_WIDTH, double height = SF_HEIGHT,
+                double padding = SF_PADDING) {
+    if (set_.empty()) {
+      return;
+    }
+    auto [min_x, max_x] = std::minmax_element(
+        set_.begin(), set_.end(),
+        [](const Point &a, const Point &b) { return a.x_ < b.x_; });
+    auto [min_y, max_y] = std::minmax_element(
+        set_.begin(), set_.end(),
+        [](const Point &a, const Point &b) { return a.y_ < b.y_; });
+    const double left = min_x->x_;
+    const double bottom = min_y->y_;
+    const double span_x = max_x->x_ - left;
+    const double span_y = max_y->y_ - bottom;
+    const double inner_width = width - 2 * padding;
+    const double inner_height = height - 2 * padding;
+    double scale = 1;
+    if (span_x > 0 || span_y > 0) {
+      const double fit_x =
+          span_x > 0 ? inner_width / span_x : inner_height / span_y;
+      const double fit_y =
+          span_y > 0 ? inner_height / span_y : inner_width / span_x;
+      scale = std::min(fit_x, fit_y);
+    }
+    // centred in the window
+    const double offset_x = padding + (inner_width - span_x * scale) / 2;
+    const double offset_y = padding + (inner_height - span_y * scale) / 2;
+    for (auto &point : set_) {
+      point.x_ = offset_x + (point.x_ - left) * scale;
+      point.y_ = offset_y + (point.y_ - bottom) * scale;
+    }
+    sync_soa();
   }
 
 private:
+  using column_t = std::vector<double, AlignedAllocator<double>>;
+
   std::vector<Point> set_;
+  bool soa_ = false;
+  column_t xs_;
+  column_t ys_;
   static constexpr size_t MIN_POINTS = 3;
   static constexpr size_t MAX_POINTS = 50;
 
+  void sync_soa() {
+    if (!soa_) {
+      return;
+    }
+    xs_.resize(set_.size());
+    ys_.resize(set_.size());
+    for (size_t i = 0; i < set_.size(); ++i) {
+      xs_[i] = set_[i].x_;
+      ys_[i] = set_[i].y_;
+    }
+  }
+
   void check_set_size() const {
     if (set_.size() < 3) {
       throw std::invalid_argument("Point set must contain at least 3 points!");
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "../perf/Trace.hpp"
+#include "Point.hpp"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+// Robust orientation test. The determinant is first evaluated in plain
+// floating point together with Shewchuk's forward error bound; only when
+// its magnitude is below the bound is the sign recomputed exactly from an
+// expansion of the six coordinate products. The answer is always the sign
+// of the exact determinant of the (double) input, for any magnitude, as
+// long as the products neither overflow nor underflow.
+namespace predicates {
+
+// Calls made on this thread and how many needed exact arithmetic.
+struct Counters {
+  uint64_t calls = 0;
+  uint64_t exact = 0;
+};
+
+inline Counters &counters() {
+  thread_local Counters counters;
+  return counters;
+}
+
+inline void resetCounters() { counters() = {}; }
+
+constexpr double EPSILON = std::numeric_limits<double>::epsilon() / 2;
+
+// bound on the error of (a - c) x (b - c) relative to |detleft| + |detright|
+constexpr double CCW_ERROR_BOUND = (3.0 + 16.0 * EPSILON) * EPSILON;
+
+// x + y = a + b exactly
+inline void twoSum(double a, double b, double &x, double &y) {
+  x = a + b;
+  double b_virtual = x - a;
+  double a_virtual = x - b_virtual;
+  y = (a - a_virtual) + (b - b_virtual);
+}
+
+// x + y = a * b exactly
+inline void twoProduct(double a, double b, double &x, double &y) {
+  x = a * b;
+  y = std::fma(a, b, -x);
+}
+
+// Adds b to the nonoverlapping expansion e[0..size) (smallest component
+// first), dropping zero components. Returns the new size.
+inline int growExpansion(double *e, int size, double b) {
+  double q = b;
+  int out = 0;
+  for (int i = 0; i < size; ++i) {
+    double h = 0;
+    twoSum(q, e[i], q, h);
+    if (h != 0) {
+      e[out++] = h;
+    }
+  }
+  if (q != 0) {
+    e[out++] = q;
+  }
+  return out;
+}
+
+// Sign of (b - a) x (c - a) computed exactly: the determinant expands to
+// bx*cy - bx*ay - ax*cy - by*cx + by*ax + ay*cx, each product is split
+// into two doubles and the twelve terms are summed into an expansion whose
+// largest component carries the sign.
+inline int exactOrientation(const Point &a, const Point &b, const Point &c) {
+  const double products[6][2] = {
+      {b.x_, c.y_},  {-b.x_, a.y_}, {-a.x_, c.y_},
+      {-b.y_, c.x_}, {b.y_, a.x_},  {a.y_, c.x_},
+  };
+  double expansion[12];
+  int size = 0;
+  for (const auto &product : products) {
+    double hi = 0;
+    double lo = 0;
+    twoProduct(product[0], product[1], hi, lo);
+    size = growExpansion(expansion, size, lo);
+    size = growExpansion(expansion, size, hi);
+  }
+  if (size == 0) {
+    return 0;
+  }
+  return expansion[size - 1] > 0 ? 1 : -1;
+}
+
+// 1 if c is left of (a, b), -1 if right, 0 if the three are collinear.
+inline int orientation(const Point &a, const Point &b, const Point &c) {
+  ++counters().calls;
+  TRACE_COUNT(ORIENTATION_TESTS, 1);
+  const double detleft = (b.x_ - a.x_) * (c.y_ - a.y_);
+  const double detright = (b.y_ - a.y_) * (c.x_ - a.x_);
+  const double det = detleft - detright;
+  const double bound =
+      CCW_ERROR_BOUND * (std::abs(detleft) + std::abs(detright));
+  if (det > bound) {
+    return 1;
+  }
+  if (-det > bound) {
+    return -1;
+  }
+  ++counters().exact;
+  return exactOrientation(a, b, c);
+}
+
+// Upper bound on the rounding error of the floating point (b - a) x (c - a)
+// for every c with |c.x - a.x| <= span_x and |c.y - a.y| <= span_y. A
+// batch-computed cross product above this is certainly a left turn.
+inline double crossErrorBound(const Point &a, const Point &b, double span_x,
+                              double span_y) {
+  const double scale = 1.0 + 4.0 * EPSILON;
+  return CCW_ERROR_BOUND * scale *
+         (std::abs(b.x_ - a.x_) * span_y + std::abs(b.y_ - a.y_) * span_x) *
+         scale;
+}
+
+// Type that holds the difference of two coordinates: exactly for integer
+// coordinates, rounded to double for float and double (so a float
+// difference isn't rounded to float's 24 bits), in T for wider types.
+template <typename T>
+using wide_t = std::conditional_t<
+    std::is_integral_v<T>, __int128,
+    std::conditional_t<(sizeof(T) <= sizeof(double)), double, T>>;
+
+template <typename T> wide_t<T> difference(T a, T b) {
+  return static_cast<wide_t<T>>(a) - static_cast<wide_t<T>>(b);
+}
+
+// Predicate policies of the hull engines. A policy provides
+//   orientation(a, b, c): 1 if c is left of (a, b), -1 if right, 0 if the
+//                         three are collinear;
+//   closer(o, p, q):      p is nearer to o than q, to order collinear points.
+
+// Exact answers for every coordinate type. Integer coordinates use 128-bit
+// integer cross products, exact as long as |coordinates| < 2^62; float and
+// double go through the filtered predicate above.
+template <typename T> struct Exact {
+  using point_type = BasicPoint<T>;
+
+  static int orientation(const point_type &a, const point_type &b,
+                         const point_type &c) {
+    if constexpr (std::is_integral_v<T>) {
+      TRACE_COUNT(ORIENTATION_TESTS, 1);
+      const __int128 det = difference(b.x_, a.x_) * difference(c.y_, a.y_) -
+                           difference(b.y_, a.y_) * difference(c.x_, a.x_);
+      return (det > 0) - (det < 0);
+    } else {
+      return predicates::orientation(toDouble(a), toDouble(b), toDouble(c));
+    }
+  }
+
+  static bool closer(const point_type &o, const point_type &p,
+                     const point_type &q) {
+    if constexpr (std::is_integral_v<T>) {
+      const __int128 pdx = difference(p.x_, o.x_);
+      const __int128 pdy = difference(p.y_, o.y_);
+      const __int128 qdx = difference(q.x_, o.x_);
+      const __int128 qdy = difference(q.y_, o.y_);
+      return pdx * pdx + pdy * pdy < qdx * qdx + qdy * qdy;
+    } else {
+      const double pdx = double(p.x_) - double(o.x_);
+      const double pdy = double(p.y_) - double(o.y_);
+      const double qdx = double(q.x_) - double(o.x_);
+      const double qdy = double(q.y_) - double(o.y_);
+      return pdx * pdx + pdy * pdy < qdx * qdx + qdy * qdy;
+    }
+  }
+
+private:
+  static Point toDouble(const point_type &p) {
+    return {static_cast<double>(p.x_), static_cast<double>(p.y_)};
+  }
+};
+
+// The plain cross product in the coordinate type, without the error bound.
+// Fastest, but nearly collinear triples may get the wrong sign.
+template <typename T> struct Fast {
+  static_assert(std::is_floating_point_v<T>,
+                "integer coordinates are always exact, use Exact");
+  using point_type = BasicPoint<T>;
+
+  static int orientation(const point_type &a, const point_type &b,
+                         const point_type &c) {
+    TRACE_COUNT(ORIENTATION_TESTS, 1);
+    const T det = (b.x_ - a.x_) * (c.y_ - a.y_) - (b.y_ - a.y_) * (c.x_ - a.x_);
+    return (det > 0) - (det < 0);
+  }
+
+  static bool closer(const point_type &o, const point_type &p,
+                     const point_type &q) {
+    const T pdx = p.x_ - o.x_;
+    const T pdy = p.y_ - o.y_;
+    const T qdx = q.x_ - o.x_;
+    const T qdy = q.y_ - o.y_;
+    return pdx * pdx + pdy * pdy < qdx * qdx + qdy * qdy;
+  }
+};
+
+} // namespace predicates
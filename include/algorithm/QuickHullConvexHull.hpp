@@ -0,0 +1,306 @@
+#pragma once
+
+#include "../parallel/ForkJoinPool.hpp"
+#include "ConvexHullEngine.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+// QuickHull. The extreme points A and B in (x, y) order split the input
+// into the points below and above AB; each side recurses on its edge: the
+// point farthest from the edge is a hull vertex c, the points in triangle
+// (a, c, b) are dropped and those beyond ac and beyond cb form the two
+// child sets. Interior points go in the first few levels, so on the usual
+// mostly-interior inputs most of the work is a handful of linear passes.
+//
+// A partition of more than PARALLEL_CUTOFF points runs on the fork/join
+// pool: blocks classify their points and count each side, a prefix sum
+// over the block counts gives every block its output offsets, and the
+// blocks scatter their points there in parallel. The two children are
+// forked; smaller sets recurse sequentially.
+//
+// The farthest point is picked on the floating point cross product, so
+// it may miss the true extreme by a rounding error; sidedness uses the
+// exact policy, and a final convexity pass drops anything that is not a
+// strict vertex.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicQuickHullConvexHull : public ConvexHullEngine<T, Policy> {
+  using Base = ConvexHullEngine<T, Policy>;
+  using Point = BasicPoint<T>;
+  using Base::candidate;
+  using Base::hull_;
+  using Base::hull_indices_;
+  using Base::materializeHull;
+  using Base::points_;
+  using Base::takeCandidates;
+
+public:
+  using Base::processedSize;
+
+  static constexpr size_t PARALLEL_CUTOFF = size_t{1} << 16;
+
+  // threads : size of the fork/join pool, 0 uses every thread of the
+  // machine, 1 runs sequentially
+  BasicQuickHullConvexHull(std::span<const Point> points,
+                           Prefilter prefilter = Prefilter::NONE,
+                           size_t threads = 0)
+      : Base(points, prefilter) {
+    const size_t shared = ForkJoinPool::shared().size();
+    if (threads == 0 || threads == shared) {
+      pool_ = &ForkJoinPool::shared();
+    } else if (threads > 1) {
+      local_pool_.emplace(threads);
+      pool_ = &*local_pool_;
+    }
+    computeHull();
+  }
+
+private:
+  static constexpr size_t BLOCK_SIZE = size_t{1} << 14;
+  static constexpr size_t NONE = SIZE_MAX;
+
+  // Points strictly beyond an edge, and the farthest of them.
+  struct Side {
+    std::vector<size_t> points;
+    size_t farthest = NONE;
+  };
+
+  ForkJoinPool *pool_ = nullptr;
+  std::optional<ForkJoinPool> local_pool_;
+
+  template <typename A, typename B> void fork(A &&a, B &&b) {
+    if (pool_ == nullptr) {
+      a();
+      b();
+    } else {
+      pool_->invoke(a, b);
+    }
+  }
+
+  static bool lexLess(const Point &p, const Point &q) {
+    return p.x_ < q.x_ || (p.x_ == q.x_ && p.y_ < q.y_);
+  }
+
+  // How far right of (a, b) the point is, up to a constant factor.
+  static double depth(const Point &a, const Point &b, const Point &p) {
+    using predicates::difference;
+    return static_cast<double>(difference(b.y_, a.y_) * difference(p.x_, a.x_) -
+                               difference(b.x_, a.x_) * difference(p.y_, a.y_));
+  }
+
+  void computeHull() {
+    hull_indices_.clear();
+    std::vector<size_t> candidates = takeCandidates();
+    if (candidates.empty()) {
+      materializeHull();
+      return;
+    }
+    auto [first, last] = std::minmax_element(
+        candidates.begin(), candidates.end(), [this](size_t p, size_t q) {
+          return lexLess(points_[p], points_[q]);
+        });
+    const size_t a = *first;
+    const size_t b = *last;
+    if (points_[a] == points_[b]) {
+      hull_indices_.push_back(a);
+      materializeHull();
+      return;
+    }
+
+    // below AB is beyond (a, b), above is beyond (b, a)
+    Side lower;
+    Side upper;
+    split(std::move(candidates), a, b, a, lower, upper);
+    std::vector<size_t> lower_chain;
+    std::vector<size_t> upper_chain;
+    fork([&] { lower_chain = chain(std::move(lower), a, b); },
+         [&] { upper_chain = chain(std::move(upper), b, a); });
+
+    std::vector<size_t> polygon;
+    polygon.reserve(lower_chain.size() + upper_chain.size() + 2);
+    polygon.push_back(a);
+    polygon.insert(polygon.end(), lower_chain.begin(), lower_chain.end());
+    polygon.push_back(b);
+    polygon.insert(polygon.end(), upper_chain.begin(), upper_chain.end());
+    makeStrictlyConvex(polygon);
+
+    hull_indices_ = std::move(polygon);
+    rotateToLowest();
+    materializeHull();
+    assert(hull_.size() <= processedSize());
+  }
+
+  // Hull vertices strictly between a and b, counter-clockwise, for the
+  // points beyond (a, b).
+  std::vector<size_t> chain(Side side, size_t a, size_t b) {
+    if (side.points.empty()) {
+      return {};
+    }
+    const size_t c = side.farthest;
+    Side first;
+    Side second;
+    split(std::move(side.points), a, c, b, first, second);
+    std::vector<size_t> left;
+    std::vector<size_t> right;
+    if (first.points.size() + second.points.size() > PARALLEL_CUTOFF) {
+      fork([&] { left = chain(std::move(first), a, c); },
+           [&] { right = chain(std::move(second), c, b); });
+    } else {
+      left = chain(std::move(first), a, c);
+      right = chain(std::move(second), c, b);
+    }
+    left.push_back(c);
+    left.insert(left.end(), right.begin(), right.end());
+    return left;
+  }
+
+  // Sends each point beyond (a, c) to `first`, beyond (c, b) to `second`
+  // and drops the others; a point can't be beyond both.
+  void split(std::vector<size_t> points, size_t a, size_t c, size_t b,
+             Side &first, Side &second) {
+    const Point &pa = points_[a];
+    const Point &pc = points_[c];
+    const Point &pb = points_[b];
+    // 1: beyond (a, c), 2: beyond (c, b), 0: neither
+    auto classify = [&](const Point &p) -> uint8_t {
+      if (Policy::orientation(pa, pc, p) < 0) {
+        return 1;
+      }
+      if (Policy::orientation(pc, pb, p) < 0) {
+        return 2;
+      }
+      return 0;
+    };
+
+    if (pool_ == nullptr || points.size() <= PARALLEL_CUTOFF) {
+      double first_depth = 0;
+      double second_depth = 0;
+      for (size_t idx : points) {
+        const Point &p = points_[idx];
+        switch (classify(p)) {
+        case 1:
+          first.points.push_back(idx);
+          keepFarthest(pa, pc, idx, first, first_depth);
+          break;
+        case 2:
+          second.points.push_back(idx);
+          keepFarthest(pc, pb, idx, second, second_depth);
+          break;
+        }
+      }
+      return;
+    }
+
+    const size_t n = points.size();
+    const size_t blocks = (n + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    struct Block {
+      size_t counts[2] = {0, 0};
+      size_t offsets[2] = {0, 0};
+      size_t farthest[2] = {NONE, NONE};
+      double depth[2] = {0, 0};
+    };
+    std::vector<uint8_t> sides(n);
+    std::vector<Block> stats(blocks);
+    pool_->forEach(blocks, 1, [&](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k) {
+        Block &block = stats[k];
+        for (size_t i = k * BLOCK_SIZE; i < std::min(n, (k + 1) * BLOCK_SIZE);
+             ++i) {
+          const Point &p = points_[points[i]];
+          const uint8_t s = classify(p);
+          sides[i] = s;
+          if (s == 0) {
+            continue;
+          }
+          ++block.counts[s - 1];
+          const double d = s == 1 ? depth(pa, pc, p) : depth(pc, pb, p);
+          if (block.farthest[s - 1] == NONE || d > block.depth[s - 1]) {
+            block.farthest[s - 1] = points[i];
+            block.depth[s - 1] = d;
+          }
+        }
+      }
+    });
+
+    // exclusive prefix sums of the block counts
+    size_t totals[2] = {0, 0};
+    double depths[2] = {0, 0};
+    Side *outputs[2] = {&first, &second};
+    for (Block &block : stats) {
+      for (int s = 0; s < 2; ++s) {
+        block.offsets[s] = totals[s];
+        totals[s] += block.counts[s];
+        if (block.farthest[s] != NONE &&
+            (outputs[s]->farthest == NONE || block.depth[s] > depths[s])) {
+          outputs[s]->farthest = block.farthest[s];
+          depths[s] = block.depth[s];
+        }
+      }
+    }
+    first.points.resize(totals[0]);
+    second.points.resize(totals[1]);
+
+    pool_->forEach(blocks, 1, [&](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; ++k) {
+        size_t next[2] = {stats[k].offsets[0], stats[k].offsets[1]};
+        for (size_t i = k * BLOCK_SIZE; i < std::min(n, (k + 1) * BLOCK_SIZE);
+             ++i) {
+          if (sides[i] != 0) {
+            outputs[sides[i] - 1]->points[next[sides[i] - 1]++] = points[i];
+          }
+        }
+      }
+    });
+  }
+
+  void keepFarthest(const Point &a, const Point &b, size_t idx, Side &side,
+                    double &best) const {
+    const double d = depth(a, b, points_[idx]);
+    if (side.farthest == NONE || d > best) {
+      side.farthest = idx;
+      best = d;
+    }
+  }
+
+  // Drops the vertices of the counter-clockwise polygon that don't turn
+  // left. polygon[0] is the lowest point in (x, y) order, a hull vertex.
+  void makeStrictlyConvex(std::vector<size_t> &polygon) const {
+    auto turn = [this](size_t a, size_t b, size_t c) {
+      return Policy::orientation(points_[a], points_[b], points_[c]);
+    };
+    size_t k = 0;
+    for (size_t idx : polygon) {
+      while (k >= 2 && turn(polygon[k - 2], polygon[k - 1], idx) <= 0) {
+        --k;
+      }
+      polygon[k++] = idx;
+    }
+    while (k >= 3 && turn(polygon[k - 2], polygon[k - 1], polygon[0]) <= 0) {
+      --k;
+    }
+    polygon.resize(k);
+  }
+
+  void rotateToLowest() {
+    if (hull_indices_.empty()) {
+      return;
+    }
+    size_t lowest = 0;
+    for (size_t i = 1; i < hull_indices_.size(); ++i) {
+      const Point &p = points_[hull_indices_[i]];
+      const Point &best = points_[hull_indices_[lowest]];
+      if (p.y_ < best.y_ || (p.y_ == best.y_ && p.x_ < best.x_)) {
+        lowest = i;
+      }
+    }
+    std::rotate(hull_indices_.begin(), hull_indices_.begin() + lowest,
+                hull_indices_.end());
+  }
+};
+
+using QuickHullConvexHull = BasicQuickHullConvexHull<>;
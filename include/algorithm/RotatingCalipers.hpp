@@ -0,0 +1,193 @@
+#pragma once
+
+#include "ConvexHullBase.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Metrics of a computed hull by rotating calipers, all in one O(h) sweep.
+// The hull must be strictly convex and counter-clockwise, as the engines
+// report it. For each edge in turn three calipers are kept: the vertex
+// farthest from the edge's line and the vertices farthest forward and
+// backward along it. Each only moves forward as the edges turn, so
+// together they go around the hull a bounded number of times.
+//
+// The farthest vertex gives the width (the least of those distances) and
+// the antipodal pairs, whose longest is the diameter; the three together
+// give the rectangle with a side on the edge, and the minimum area and
+// minimum perimeter rectangles both have a side on some hull edge. The
+// metrics are computed in double.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicRotatingCalipers {
+public:
+  using coordinate_type = T;
+  using point_type = BasicPoint<T>;
+
+  // The two farthest apart vertices.
+  struct Diameter {
+    size_t first = 0;
+    size_t second = 0;
+    double length = 0;
+  };
+
+  // The least distance between two parallel lines enclosing the hull, one
+  // through edge (edge, edge + 1), the other through `vertex`.
+  struct Width {
+    size_t edge = 0;
+    size_t vertex = 0;
+    double width = 0;
+  };
+
+  // Enclosing rectangle with a side on edge (edge, edge + 1), corners
+  // counter-clockwise starting on that side.
+  struct Rectangle {
+    std::array<Point, 4> corners;
+    size_t edge = 0;
+    double area = 0;
+    double perimeter = 0;
+  };
+
+  explicit BasicRotatingCalipers(std::span<const point_type> hull) {
+    if (hull.empty()) {
+      throw std::invalid_argument("The hull is empty!");
+    }
+    const size_t h = hull.size();
+    for (size_t i = 0; h >= 3 && i < h; ++i) {
+      if (Policy::orientation(hull[i], hull[(i + 1) % h],
+                              hull[(i + 2) % h]) <= 0) {
+        throw std::invalid_argument(
+            "The hull must be strictly convex and counter-clockwise!");
+      }
+    }
+    vertices_.reserve(h);
+    for (const point_type &vertex : hull) {
+      vertices_.emplace_back(static_cast<double>(vertex.x_),
+                             static_cast<double>(vertex.y_));
+    }
+    sweep();
+  }
+
+  explicit BasicRotatingCalipers(const ConvexHullBase &hull)
+    requires std::is_same_v<T, double>
+      : BasicRotatingCalipers(std::span<const point_type>(hull.getHull())) {}
+
+  const Diameter &getDiameter() const { return diameter_; }
+
+  const Width &getWidth() const { return width_; }
+
+  const Rectangle &getMinAreaRectangle() const { return min_area_; }
+
+  const Rectangle &getMinPerimeterRectangle() const { return min_perimeter_; }
+
+private:
+  std::vector<Point> vertices_;
+  Diameter diameter_;
+  Width width_;
+  Rectangle min_area_;
+  Rectangle min_perimeter_;
+
+  static double dot(const Point &u, const Point &v) {
+    return u.x_ * v.x_ + u.y_ * v.y_;
+  }
+
+  static double length(const Point &u) { return std::sqrt(dot(u, u)); }
+
+  void sweep() {
+    const size_t h = vertices_.size();
+    const std::vector<Point> &v = vertices_;
+    if (h < 3) {
+      // a point or a segment
+      diameter_ = {0, h - 1, length(v[h - 1] - v[0])};
+      width_ = {0, h - 1, 0};
+      min_area_ = rectangle(0, h - 1, h - 1, 0, 0);
+      min_perimeter_ = min_area_;
+      return;
+    }
+
+    auto next = [h](size_t i) { return i + 1 == h ? 0 : i + 1; };
+    // the calipers: forward along the edge, off the edge, backward
+    size_t forward = 0;
+    size_t top = 0;
+    size_t backward = 0;
+    for (size_t i = 0; i < h; ++i) {
+      const Point edge = v[next(i)] - v[i];
+      const Point normal(-edge.y_, edge.x_);
+      while (dot(v[next(forward)] - v[forward], edge) > 0) {
+        forward = next(forward);
+      }
+      if (i == 0) {
+        top = forward;
+      }
+      while (dot(v[next(top)] - v[top], normal) > 0) {
+        top = next(top);
+      }
+      if (i == 0) {
+        backward = top;
+      }
+      while (dot(v[next(backward)] - v[backward], edge) < 0) {
+        backward = next(backward);
+      }
+
+      // (i, top) and (i + 1, top) are antipodal, and so are both with the
+      // next vertex when the edge at top is parallel to edge i
+      const bool parallel = dot(v[next(top)] - v[top], normal) == 0;
+      for (size_t a : {i, next(i)}) {
+        for (size_t b : {top, parallel ? next(top) : top}) {
+          const double d = length(v[b] - v[a]);
+          if (d > diameter_.length) {
+            diameter_ = {a, b, d};
+          }
+        }
+      }
+
+      const double height = dot(v[top] - v[i], normal) / length(edge);
+      if (i == 0 || height < width_.width) {
+        width_ = {i, top, height};
+      }
+
+      const Rectangle candidate = rectangle(i, next(i), forward, top, backward);
+      if (i == 0 || candidate.area < min_area_.area) {
+        min_area_ = candidate;
+      }
+      if (i == 0 || candidate.perimeter < min_perimeter_.perimeter) {
+        min_perimeter_ = candidate;
+      }
+    }
+  }
+
+  // The rectangle with a side on the line through vertices a and b (the
+  // x axis when they coincide), reaching to the given calipers.
+  Rectangle rectangle(size_t a, size_t b, size_t forward, size_t top,
+                      size_t backward) const {
+    const std::vector<Point> &v = vertices_;
+    const Point edge = v[b] - v[a];
+    const double edge_length = length(edge);
+    const Point u = edge_length > 0 ? Point(edge.x_ / edge_length,
+                                            edge.y_ / edge_length)
+                                    : Point(1, 0);
+    const Point n(-u.y_, u.x_);
+    const double front = dot(v[forward] - v[a], u);
+    const double back = dot(v[backward] - v[a], u);
+    const double height = dot(v[top] - v[a], n);
+
+    auto at = [&](double along, double up) {
+      return Point(v[a].x_ + along * u.x_ + up * n.x_,
+                   v[a].y_ + along * u.y_ + up * n.y_);
+    };
+    Rectangle result;
+    result.corners = {at(back, 0), at(front, 0), at(front, height),
+                      at(back, height)};
+    result.edge = a;
+    result.area = (front - back) * height;
+    result.perimeter = 2 * ((front - back) + height);
+    return result;
+  }
+};
+
+using RotatingCalipers = BasicRotatingCalipers<>;
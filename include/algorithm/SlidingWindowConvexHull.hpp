@@ -0,0 +1,201 @@
+#pragma once
+
+#include "IncrementalConvexHull.hpp"
+#include "MonotoneChain.hpp"
+#include "Point.hpp"
+#include "Predicates.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Convex hull of the latest points of a time-ordered feed: the last
+// `capacity` points, or those newer than a cut-off time passed to
+// popBefore(). Points leave in arrival order, so the window is a queue
+// kept as two stacks:
+//  - back:  the newest points, in an insert-only incremental hull;
+//  - front: the oldest points, in an incremental hull built from the
+//           newest of them to the oldest, so that dropping the oldest
+//           point is undoing the latest insert.
+// When the front runs empty the back is moved over. Each point is inserted
+// twice and undone once, O(log h) amortized per update. getHull() merges
+// the two chains in O(h_front + h_back).
+//
+// Indices count the points of the feed from 0.
+template <typename T = double, typename Policy = predicates::Exact<T>>
+class BasicSlidingWindowConvexHull {
+public:
+  using coordinate_type = T;
+  using point_type = BasicPoint<T>;
+
+  // capacity : window length in points, 0 when the caller pops instead
+  explicit BasicSlidingWindowConvexHull(size_t capacity = 0)
+      : capacity_{capacity} {}
+
+  // Appends the newest point, dropping the oldest one if the window is full.
+  void push(const point_type &point, double time = 0) {
+    if (!window_.empty() && time < window_.back().time) {
+      throw std::invalid_argument("Points must arrive in time order!");
+    }
+    window_.push_back({point, time});
+    back_.insert(point, pushed_++);
+    dirty_ = true;
+    if (capacity_ != 0 && window_.size() > capacity_) {
+      pop();
+    }
+  }
+
+  // Drops the oldest point of the window.
+  void pop() {
+    if (window_.empty()) {
+      throw std::invalid_argument("The window is empty!");
+    }
+    if (front_size_ == 0) {
+      moveBackToFront();
+    }
+    front_.undo();
+    --front_size_;
+    window_.pop_front();
+    ++popped_;
+    dirty_ = true;
+  }
+
+  // Drops every point older than `time`.
+  void popBefore(double time) {
+    while (!window_.empty() && window_.front().time < time) {
+      pop();
+    }
+  }
+
+  size_t windowSize() const { return window_.size(); }
+
+  const std::vector<point_type> &getHull() const {
+    refresh();
+    return hull_;
+  }
+
+  // Hull vertices as positions in the feed, in the order of getHull().
+  const std::vector<size_t> &getHullIndices() const {
+    refresh();
+    return hull_indices_;
+  }
+
+  size_t size() const { return getHull().size(); }
+
+private:
+  struct Entry {
+    point_type point;
+    double time;
+  };
+  using hull_t = BasicIncrementalConvexHull<T, Policy>;
+
+  size_t capacity_;
+  // the window, oldest first; its first front_size_ points are in front_
+  std::deque<Entry> window_;
+  size_t front_size_ = 0;
+  size_t pushed_ = 0;
+  size_t popped_ = 0;
+  hull_t front_;
+  hull_t back_;
+
+  mutable bool dirty_ = false;
+  mutable std::vector<point_type> hull_;
+  mutable std::vector<size_t> hull_indices_;
+
+  void moveBackToFront() {
+    front_ = hull_t();
+    front_.enableUndo();
+    for (size_t i = window_.size(); i > 0; --i) {
+      front_.insert(window_[i - 1].point, popped_ + i - 1);
+    }
+    front_size_ = window_.size();
+    back_ = hull_t();
+  }
+
+  struct Vertex {
+    point_type point;
+    size_t index;
+  };
+
+  // One chain of the hull of both stacks: the two chains merged by x, one
+  // point kept per x, then one monotone chain pass over them.
+  template <bool Upper> void mergeChains(std::vector<Vertex> &chain) const {
+    std::vector<Vertex> front;
+    std::vector<Vertex> back;
+    auto collect = [](std::vector<Vertex> &out) {
+      return [&out](const point_type &point, size_t index) {
+        out.push_back({point, index});
+      };
+    };
+    if constexpr (Upper) {
+      front_.visitUpperChain(collect(front));
+      back_.visitUpperChain(collect(back));
+    } else {
+      front_.visitLowerChain(collect(front));
+      back_.visitLowerChain(collect(back));
+    }
+    std::vector<Vertex> merged(front.size() + back.size());
+    std::merge(front.begin(), front.end(), back.begin(), back.end(),
+               merged.begin(), [](const Vertex &a, const Vertex &b) {
+                 if (a.point.x_ != b.point.x_) {
+                   return a.point.x_ < b.point.x_;
+                 }
+                 // of two points at one x the chain keeps the outer one,
+                 // which goes last
+                 return Upper ? a.point.y_ < b.point.y_
+                              : a.point.y_ > b.point.y_;
+               });
+    size_t kept = 0;
+    for (const Vertex &vertex : merged) {
+      if (kept > 0 && merged[kept - 1].point.x_ == vertex.point.x_) {
+        --kept;
+      }
+      merged[kept++] = vertex;
+    }
+    merged.resize(kept);
+
+    chain.clear();
+    monotone_chain::buildChain<Upper, Policy>(
+        merged.begin(), merged.end(), chain,
+        [](const Vertex &vertex) { return vertex.point; });
+  }
+
+  void refresh() const {
+    if (!dirty_) {
+      return;
+    }
+    dirty_ = false;
+    std::vector<Vertex> lower;
+    std::vector<Vertex> upper;
+    mergeChains<false>(lower);
+    mergeChains<true>(upper);
+
+    hull_.clear();
+    hull_indices_.clear();
+    auto push = [this](const Vertex &vertex) {
+      if (!hull_.empty() &&
+          (hull_.back() == vertex.point || hull_[0] == vertex.point)) {
+        return;
+      }
+      hull_.push_back(vertex.point);
+      hull_indices_.push_back(vertex.index);
+    };
+    std::for_each(lower.begin(), lower.end(), push);
+    std::for_each(upper.rbegin(), upper.rend(), push);
+
+    size_t lowest = 0;
+    for (size_t i = 1; i < hull_.size(); ++i) {
+      if (hull_[i].y_ < hull_[lowest].y_ ||
+          (hull_[i].y_ == hull_[lowest].y_ && hull_[i].x_ < hull_[lowest].x_)) {
+        lowest = i;
+      }
+    }
+    std::rotate(hull_.begin(), hull_.begin() + lowest, hull_.end());
+    std::rotate(hull_indices_.begin(), hull_indices_.begin() + lowest,
+                hull_indices_.end());
+  }
+};
+
+using SlidingWindowConvexHull = BasicSlidingWindowConvexHull<>;
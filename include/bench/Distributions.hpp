@@ -0,0 +1,102 @@
+#pragma once
+
+#include "../algorithm/Point.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Point distributions for the benchmarks, all in the unit square or disk
+// and reproducible from a seed. A distribution is named by a string, so it
+// can be picked on the command line:
+//   uniform      the unit square
+//   disk         the unit disk, hull ~ n^1/3
+//   circle       the unit circle, every point on the hull
+//   gaussian     a standard normal in x and y, hull ~ sqrt(log n)
+//   clustered    100 small gaussian clusters in the unit square
+//   hull:<f>     a fraction f of the points evenly spaced on the unit
+//                circle, at least 3, the rest strictly inside their
+//                polygon, so the hull has exactly those points
+namespace bench {
+
+inline const std::vector<std::string> &distributionNames() {
+  static const std::vector<std::string> names{
+      "uniform", "disk", "circle", "gaussian", "clustered", "hull:<f>"};
+  return names;
+}
+
+inline std::vector<Point> generateDistribution(const std::string &name,
+                                               size_t n, uint64_t seed = 1) {
+  std::mt19937_64 gen(seed);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::vector<Point> points;
+  points.reserve(n);
+  auto inDisk = [&](double radius) {
+    const double r = std::sqrt(unit(gen)) * radius;
+    const double angle = unit(gen) * 2 * M_PI;
+    return Point(r * std::cos(angle), r * std::sin(angle));
+  };
+
+  if (name == "uniform") {
+    for (size_t i = 0; i < n; ++i) {
+      points.emplace_back(unit(gen), unit(gen));
+    }
+  } else if (name == "disk") {
+    for (size_t i = 0; i < n; ++i) {
+      points.push_back(inDisk(1));
+    }
+  } else if (name == "circle") {
+    for (size_t i = 0; i < n; ++i) {
+      const double angle = 2 * M_PI * i / n;
+      points.emplace_back(std::cos(angle), std::sin(angle));
+    }
+  } else if (name == "gaussian") {
+    std::normal_distribution<double> normal(0.0, 1.0);
+    for (size_t i = 0; i < n; ++i) {
+      points.emplace_back(normal(gen), normal(gen));
+    }
+  } else if (name == "clustered") {
+    const size_t clusters = 100;
+    std::normal_distribution<double> spread(0.0, 0.005);
+    for (size_t c = 0; c < clusters; ++c) {
+      const Point centre(unit(gen), unit(gen));
+      for (size_t i = c * n / clusters; i < (c + 1) * n / clusters; ++i) {
+        points.push_back(centre + Point(spread(gen), spread(gen)));
+      }
+    }
+  } else if (name.rfind("hull:", 0) == 0) {
+    size_t parsed = 0;
+    double fraction = -1;
+    try {
+      fraction = std::stod(name.substr(5), &parsed);
+    } catch (const std::exception &) {
+    }
+    if (parsed != name.size() - 5 || !(fraction >= 0 && fraction <= 1)) {
+      throw std::invalid_argument("Hull fraction must be in [0, 1]: " + name);
+    }
+    // the hull points evenly spaced on the circle from a random angle, the
+    // others in a disk inside the inscribed circle of their polygon, of
+    // radius cos(pi / k), so none of them can be on the hull; a hull has at
+    // least 3 points, so fewer are never asked for
+    const size_t requested = static_cast<size_t>(std::llround(fraction * n));
+    const size_t on_hull = std::min(n, std::max<size_t>(3, requested));
+    const double phase = unit(gen) * 2 * M_PI;
+    for (size_t i = 0; i < on_hull; ++i) {
+      const double angle = phase + 2 * M_PI * i / on_hull;
+      points.emplace_back(std::cos(angle), std::sin(angle));
+    }
+    const double inner = 0.9 * std::cos(M_PI / std::max<size_t>(on_hull, 3));
+    for (size_t i = on_hull; i < n; ++i) {
+      points.push_back(inDisk(inner));
+    }
+    std::shuffle(points.begin(), points.end(), gen);
+  } else {
+    throw std::invalid_argument("Unknown distribution: " + name);
+  }
+  return points;
+}
+
+} // namespace bench
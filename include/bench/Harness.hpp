@@ -0,0 +1,273 @@
+#pragma once
+
+#include "../perf/PhaseCounters.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Timing for the benchmarks: warm-up runs that are thrown away, then timed
+// runs on the steady clock in nanoseconds, summarized by their median and
+// tail percentiles, and written out as JSON. One more run can be profiled
+// for the hardware counters, in total and per phase (see PhaseCounters.hpp).
+namespace bench {
+
+struct Summary {
+  double min_ns = 0;
+  double median_ns = 0;
+  double mean_ns = 0;
+  double p95_ns = 0;
+  double p99_ns = 0;
+  double max_ns = 0;
+};
+
+struct Measurement {
+  std::string engine;
+  std::string distribution;
+  size_t n = 0;
+  size_t hull_size = 0;
+  std::vector<double> runs_ns;
+  Summary summary;
+  // from the profiled run, if there was one
+  bool profiled = false;
+  perf::Counts total;
+  std::vector<std::pair<std::string, perf::Counts>> phases;
+};
+
+// Nearest-rank percentile of sorted samples, p in (0, 1].
+inline double percentile(const std::vector<double> &sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+inline Summary summarize(std::vector<double> samples) {
+  Summary summary;
+  if (samples.empty()) {
+    return summary;
+  }
+  std::sort(samples.begin(), samples.end());
+  summary.min_ns = samples.front();
+  summary.max_ns = samples.back();
+  summary.median_ns = percentile(samples, 0.5);
+  summary.p95_ns = percentile(samples, 0.95);
+  summary.p99_ns = percentile(samples, 0.99);
+  double total = 0;
+  for (double sample : samples) {
+    total += sample;
+  }
+  summary.mean_ns = total / samples.size();
+  return summary;
+}
+
+// Runs `run` (which returns the hull size) warmup times untimed, then
+// `runs` times timed. The hull size is kept so the work can't be optimized
+// away and the engines can be checked against each other.
+template <typename Run>
+Measurement measure(Run &&run, size_t warmup, size_t runs) {
+  Measurement measurement;
+  for (size_t i = 0; i < warmup; ++i) {
+    measurement.hull_size = run();
+  }
+  measurement.runs_ns.reserve(runs);
+  for (size_t i = 0; i < runs; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    measurement.hull_size = run();
+    auto end = std::chrono::steady_clock::now();
+    measurement.runs_ns.push_back(
+        std::chrono::duration<double, std::nano>(end - start).count());
+  }
+  measurement.summary = summarize(measurement.runs_ns);
+  return measurement;
+}
+
+// One more, untimed, run of `run` with the profiler's counters read around
+// it and the profiler active, so the engine's phases are counted too. It is
+// kept out of the timed runs, whose times would include the reads.
+template <typename Run>
+void profile(Run &&run, perf::PhaseProfiler &profiler,
+             Measurement &measurement) {
+  profiler.clear();
+  {
+    perf::ProfileScope scope(profiler);
+    const std::array<uint64_t, perf::EVENTS> before = profiler.read();
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto end = std::chrono::steady_clock::now();
+    const std::array<uint64_t, perf::EVENTS> after = profiler.read();
+    measurement.total = {};
+    measurement.total.calls = 1;
+    measurement.total.time_ns =
+        std::chrono::duration<double, std::nano>(end - start).count();
+    for (int event = 0; event < perf::EVENTS; ++event) {
+      measurement.total.events[event] = after[event] - before[event];
+    }
+  }
+  measurement.profiled = true;
+  measurement.phases = profiler.phases();
+}
+
+// Pins the calling thread to a CPU, the first one it may run on when cpu is
+// negative, so the runs don't migrate between cores. Returns the CPU, or -1
+// if pinning isn't available.
+inline int pinToCpu(int cpu) {
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    return -1;
+  }
+  if (cpu < 0) {
+    for (int i = 0; i < CPU_SETSIZE && cpu < 0; ++i) {
+      cpu = CPU_ISSET(i, &allowed) ? i : -1;
+    }
+  }
+  if (cpu < 0 || cpu >= CPU_SETSIZE) {
+    return -1;
+  }
+  cpu_set_t pinned;
+  CPU_ZERO(&pinned);
+  CPU_SET(cpu, &pinned);
+  return sched_setaffinity(0, sizeof(pinned), &pinned) == 0 ? cpu : -1;
+#else
+  (void)cpu;
+  return -1;
+#endif
+}
+
+struct Config {
+  std::vector<std::string> engines;
+  std::vector<std::string> distributions;
+  std::vector<size_t> sizes;
+  size_t warmup = 2;
+  size_t runs = 10;
+  uint64_t seed = 1;
+  // requested CPU, -1 for the first allowed one; pinned is what we got
+  bool pin = true;
+  int cpu = -1;
+  int pinned = -1;
+  // the counters run, and which of the counters could be opened for it
+  bool counters = true;
+  std::array<bool, perf::EVENTS> available{};
+  std::string counters_error;
+};
+
+namespace detail {
+
+inline void writeString(std::ostream &out, const std::string &value) {
+  out << '"';
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+template <typename T>
+void writeArray(std::ostream &out, const std::vector<T> &values) {
+  out << '[';
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i > 0) {
+      out << ", ";
+    }
+    if constexpr (std::is_same_v<T, std::string>) {
+      writeString(out, values[i]);
+    } else {
+      out << values[i];
+    }
+  }
+  out << ']';
+}
+
+inline void writeCounts(std::ostream &out, const perf::Counts &counts,
+                        const std::array<bool, perf::EVENTS> &available) {
+  out << "\"calls\": " << counts.calls << ", \"time_ns\": " << counts.time_ns;
+  for (int event = 0; event < perf::EVENTS; ++event) {
+    out << ", \"" << perf::eventName(perf::Event(event)) << "\": ";
+    if (available[event]) {
+      out << counts.events[event];
+    } else {
+      out << "null";
+    }
+  }
+}
+
+} // namespace detail
+
+inline void writeJson(std::ostream &out, const Config &config,
+                      const std::vector<Measurement> &measurements) {
+  const auto precision = out.precision(10);
+  out << "{\n  \"config\": {\n    \"engines\": ";
+  detail::writeArray(out, config.engines);
+  out << ",\n    \"distributions\": ";
+  detail::writeArray(out, config.distributions);
+  out << ",\n    \"sizes\": ";
+  detail::writeArray(out, config.sizes);
+  out << ",\n    \"warmup\": " << config.warmup
+      << ",\n    \"runs\": " << config.runs << ",\n    \"seed\": "
+      << config.seed << ",\n    \"cpu\": ";
+  if (config.pinned >= 0) {
+    out << config.pinned;
+  } else {
+    out << "null";
+  }
+  out << ",\n    \"clock\": \"steady_clock\"";
+  if (config.counters) {
+    out << ",\n    \"counters\": {";
+    for (int event = 0; event < perf::EVENTS; ++event) {
+      out << (event > 0 ? ", \"" : "\"")
+          << perf::eventName(perf::Event(event))
+          << "\": " << (config.available[event] ? "true" : "false");
+    }
+    out << "},\n    \"counters_error\": ";
+    detail::writeString(out, config.counters_error);
+  }
+  out << "\n  },\n  \"results\": [";
+  for (size_t i = 0; i < measurements.size(); ++i) {
+    const Measurement &m = measurements[i];
+    out << (i > 0 ? ",\n" : "\n") << "    {\"engine\": ";
+    detail::writeString(out, m.engine);
+    out << ", \"distribution\": ";
+    detail::writeString(out, m.distribution);
+    out << ", \"n\": " << m.n << ", \"hull_size\": " << m.hull_size
+        << ",\n     \"min_ns\": " << m.summary.min_ns
+        << ", \"median_ns\": " << m.summary.median_ns
+        << ", \"mean_ns\": " << m.summary.mean_ns
+        << ", \"p95_ns\": " << m.summary.p95_ns
+        << ", \"p99_ns\": " << m.summary.p99_ns
+        << ", \"max_ns\": " << m.summary.max_ns << ",\n     \"runs_ns\": ";
+    detail::writeArray(out, m.runs_ns);
+    if (m.profiled) {
+      out << ",\n     \"counters\": {";
+      detail::writeCounts(out, m.total, config.available);
+      out << "},\n     \"phases\": [";
+      for (size_t p = 0; p < m.phases.size(); ++p) {
+        out << (p > 0 ? ",\n       {" : "\n       {") << "\"name\": ";
+        detail::writeString(out, m.phases[p].first);
+        out << ", ";
+        detail::writeCounts(out, m.phases[p].second, config.available);
+        out << '}';
+      }
+      out << ']';
+    }
+    out << '}';
+  }
+  out << "\n  ]\n}\n";
+  out.precision(precision);
+}
+
+} // namespace bench
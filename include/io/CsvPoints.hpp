@@ -0,0 +1,183 @@
+#pragma once
+
+#include "../algorithm/Point.hpp"
+#include "../parallel/ThreadPool.hpp"
+#include "MappedFile.hpp"
+#include <charconv>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Text point files: one point per line, x and y separated by commas,
+// semicolons, spaces or tabs. Blank lines and lines starting with '#' are
+// skipped, and so is the first other line if its first field isn't a
+// number (a column header). Any other malformed line is an error.
+namespace csv {
+
+namespace detail {
+
+inline bool isSeparator(char c) {
+  return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char *skipSeparators(const char *it, const char *end) {
+  while (it != end && isSeparator(*it)) {
+    ++it;
+  }
+  return it;
+}
+
+template <typename T>
+const char *parseNumber(const char *it, const char *end, T &value) {
+  // from_chars doesn't take the leading '+' that some exporters write
+  if (it != end && *it == '+') {
+    ++it;
+  }
+  auto [next, error] = std::from_chars(it, end, value);
+  return error == std::errc() ? next : nullptr;
+}
+
+// Parses the lines starting in bytes [begin, end) of the text and appends
+// their points. Returns the offset of the first malformed line, or SIZE_MAX.
+template <typename T>
+size_t parseRange(const char *text, size_t begin, size_t end,
+                  std::vector<BasicPoint<T>> &points) {
+  const char *it = text + begin;
+  const char *const stop = text + end;
+  while (it < stop) {
+    const char *line = it;
+    const char *eol = it;
+    while (eol != stop && *eol != '\n') {
+      ++eol;
+    }
+    it = eol == stop ? eol : eol + 1;
+
+    const char *cursor = skipSeparators(line, eol);
+    if (cursor == eol || *cursor == '#') {
+      continue;
+    }
+    T x{};
+    T y{};
+    cursor = parseNumber(cursor, eol, x);
+    if (cursor != nullptr) {
+      cursor = parseNumber(skipSeparators(cursor, eol), eol, y);
+    }
+    if (cursor == nullptr || skipSeparators(cursor, eol) != eol) {
+      return static_cast<size_t>(line - text);
+    }
+    points.emplace_back(x, y);
+  }
+  return SIZE_MAX;
+}
+
+// Offset of the first line to parse: the first line that isn't blank or a
+// comment, or the line after it when its first field isn't a number (a
+// header).
+template <typename T> size_t dataStart(const char *text, size_t size) {
+  const char *it = text;
+  const char *const stop = text + size;
+  while (it < stop) {
+    const char *eol = it;
+    while (eol != stop && *eol != '\n') {
+      ++eol;
+    }
+    const char *next = eol == stop ? eol : eol + 1;
+    const char *cursor = skipSeparators(it, eol);
+    if (cursor != eol && *cursor != '#') {
+      T x{};
+      return parseNumber(cursor, eol, x) == nullptr
+                 ? static_cast<size_t>(next - text)
+                 : static_cast<size_t>(it - text);
+    }
+    it = next;
+  }
+  return size;
+}
+
+} // namespace detail
+
+// Reads a text point file. The mapped text is cut at line boundaries into
+// `tasks` ranges (0: one per thread of the pool) that are parsed in
+// parallel with std::from_chars and concatenated in file order.
+template <typename T = double>
+std::vector<BasicPoint<T>> read(const std::string &path,
+                                ThreadPool &pool = ThreadPool::shared(),
+                                size_t tasks = 0) {
+  MappedFile file{path};
+  const char *text = file.data();
+  const size_t size = file.size();
+  if (tasks == 0) {
+    tasks = pool.size();
+  }
+  // small files aren't worth splitting
+  tasks = std::max<size_t>(1, std::min(tasks, size / (1 << 16)));
+
+  std::vector<size_t> cuts(tasks + 1, size);
+  cuts[0] = detail::dataStart<T>(text, size);
+  for (size_t i = 1; i < tasks; ++i) {
+    size_t cut = std::max(size * i / tasks, cuts[i - 1]);
+    while (cut < size && text[cut - 1] != '\n') {
+      ++cut;
+    }
+    cuts[i] = cut;
+  }
+
+  std::vector<std::vector<BasicPoint<T>>> parts(tasks);
+  std::vector<size_t> errors(tasks, SIZE_MAX);
+  pool.parallelFor(
+      tasks,
+      [&](size_t i) {
+        // about 20 bytes per line, a guess to save most regrowth
+        parts[i].reserve((cuts[i + 1] - cuts[i]) / 20);
+        errors[i] = detail::parseRange(text, cuts[i], cuts[i + 1], parts[i]);
+      },
+      tasks);
+
+  for (size_t error : errors) {
+    if (error != SIZE_MAX) {
+      throw std::invalid_argument(path + ": malformed line at byte " +
+                                  std::to_string(error));
+    }
+  }
+  size_t total = 0;
+  for (const auto &part : parts) {
+    total += part.size();
+  }
+  std::vector<BasicPoint<T>> points;
+  points.reserve(total);
+  for (const auto &part : parts) {
+    points.insert(points.end(), part.begin(), part.end());
+  }
+  return points;
+}
+
+// Writes one "x,y" line per point, in the shortest form that reads back to
+// the same value.
+template <typename T>
+void write(const std::string &path, std::span<const BasicPoint<T>> points) {
+  std::ofstream file(path, std::ios::binary);
+  file << "x,y\n";
+  std::string buffer;
+  char number[64];
+  for (const auto &point : points) {
+    auto end = std::to_chars(number, number + sizeof(number), point.x_).ptr;
+    buffer.append(number, end);
+    buffer.push_back(',');
+    end = std::to_chars(number, number + sizeof(number), point.y_).ptr;
+    buffer.append(number, end);
+    buffer.push_back('\n');
+    if (buffer.size() >= (1 << 16)) {
+      file.write(buffer.data(), buffer.size());
+      buffer.clear();
+    }
+  }
+  file.write(buffer.data(), buffer.size());
+  if (!file) {
+    throw std::runtime_error("Can't write " + path);
+  }
+}
+
+} // namespace csv
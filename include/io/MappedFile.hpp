@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Read-only memory mapping of a whole file. Nothing is read until the bytes
+// are touched, and release() hands pages that are done with back to the
+// kernel, so a file far larger than RAM can be walked through.
+class MappedFile {
+public:
+  explicit MappedFile(const std::string &path) {
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+      fail("Can't open " + path);
+    }
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) {
+      fail("Can't stat " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ == 0) {
+      return;
+    }
+    void *data = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data == MAP_FAILED) {
+      fail("Can't map " + path);
+    }
+    data_ = static_cast<const char *>(data);
+    ::madvise(data, size_, MADV_SEQUENTIAL);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char *>(data_), size_);
+    }
+    ::close(fd_);
+  }
+
+  // The first byte is page aligned.
+  const char *data() const { return data_; }
+
+  size_t size() const { return size_; }
+
+  // Drops the pages lying entirely in bytes [begin, end) from memory; they
+  // are read again from the file if touched later.
+  void release(size_t begin, size_t end) const {
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    begin = (begin + page - 1) / page * page;
+    end = end / page * page;
+    if (begin < end) {
+      ::madvise(const_cast<char *>(data_) + begin, end - begin,
+                MADV_DONTNEED);
+    }
+  }
+
+private:
+  int fd_ = -1;
+  size_t size_ = 0;
+  const char *data_ = nullptr;
+
+  [[noreturn]] void fail(const std::string &what) {
+    std::string reason = std::strerror(errno);
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+    throw std::runtime_error(what + ": " + reason);
+  }
+};
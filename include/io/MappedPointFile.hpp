@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../algorithm/Point.hpp"
+#include "MappedFile.hpp"
+#include <span>
+#include <stdexcept>
+#include <string>
+
+// A file of packed points, x then y for each, in the machine's byte order
+// and without a header, mapped read-only.
+template <typename T = double> class BasicMappedPointFile {
+public:
+  using point_type = BasicPoint<T>;
+
+  explicit BasicMappedPointFile(const std::string &path) : file_{path} {
+    if (file_.size() % sizeof(point_type) != 0) {
+      throw std::invalid_argument(path + " is not a whole number of points!");
+    }
+  }
+
+  std::span<const point_type> points() const {
+    return {reinterpret_cast<const point_type *>(file_.data()), size()};
+  }
+
+  size_t size() const { return file_.size() / sizeof(point_type); }
+
+  // Drops the pages holding only points in [begin, end) from memory.
+  void release(size_t begin, size_t end) const {
+    file_.release(begin * sizeof(point_type), end * sizeof(point_type));
+  }
+
+private:
+  MappedFile file_;
+};
+
+using MappedPointFile = BasicMappedPointFile<>;
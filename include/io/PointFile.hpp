@@ -0,0 +1,222 @@
+#pragma once
+
+#include "../algorithm/Point.hpp"
+#include "../simd/Orientation.hpp"
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Binary columnar point file, in the machine's byte order:
+//   a 64-byte PointFileHeader,
+//   the x column: count coordinates of the header's type,
+//   zero padding up to a multiple of 64 bytes,
+//   the y column, same layout.
+// Both columns start on a 64-byte boundary of the file, and so of its
+// mapping, so PointFile hands them out in place.
+enum class CoordinateType : uint32_t {
+  FLOAT = 1,
+  DOUBLE = 2,
+  INT32 = 3,
+  INT64 = 4
+};
+
+template <typename T> constexpr CoordinateType coordinateTypeOf() {
+  if constexpr (std::is_same_v<T, float>) {
+    return CoordinateType::FLOAT;
+  } else if constexpr (std::is_same_v<T, double>) {
+    return CoordinateType::DOUBLE;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return CoordinateType::INT32;
+  } else {
+    static_assert(std::is_same_v<T, int64_t>, "unsupported coordinate type");
+    return CoordinateType::INT64;
+  }
+}
+
+inline size_t coordinateSize(CoordinateType type) {
+  switch (type) {
+  case CoordinateType::FLOAT:
+  case CoordinateType::INT32:
+    return 4;
+  case CoordinateType::DOUBLE:
+  case CoordinateType::INT64:
+    return 8;
+  }
+  throw std::invalid_argument("Unknown coordinate type!");
+}
+
+struct PointFileHeader {
+  static constexpr char MAGIC[8] = {'H', 'U', 'L', 'L', 'P', 'T', 'S', '\0'};
+  static constexpr uint32_t VERSION = 1;
+  static constexpr size_t ALIGNMENT = 64;
+
+  char magic[8];
+  uint32_t version;
+  CoordinateType type;
+  uint64_t count;
+  // bounding box, rounded to double for the integer types
+  double min_x;
+  double min_y;
+  double max_x;
+  double max_y;
+  uint64_t reserved;
+
+  // Bytes taken by one column with its padding.
+  size_t columnBytes() const {
+    size_t bytes = count * coordinateSize(type);
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+  }
+};
+
+static_assert(sizeof(PointFileHeader) == PointFileHeader::ALIGNMENT,
+              "the columns must start aligned");
+
+// Zero-copy reader: the file is mapped and the columns are read in place.
+class PointFile {
+public:
+  explicit PointFile(const std::string &path) : file_{path} {
+    if (file_.size() < sizeof(PointFileHeader)) {
+      throw std::invalid_argument(path + " is not a point file!");
+    }
+    std::memcpy(&header_, file_.data(), sizeof(header_));
+    if (std::memcmp(header_.magic, PointFileHeader::MAGIC, 8) != 0) {
+      throw std::invalid_argument(path + " is not a point file!");
+    }
+    if (header_.version != PointFileHeader::VERSION) {
+      throw std::invalid_argument(path + ": unsupported version " +
+                                  std::to_string(header_.version));
+    }
+    coordinateSize(header_.type);
+    if (file_.size() < sizeof(PointFileHeader) + 2 * header_.columnBytes()) {
+      throw std::invalid_argument(path + " is truncated!");
+    }
+  }
+
+  // Whether the file starts like a point file.
+  static bool isPointFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[8] = {};
+    file.read(magic, sizeof(magic));
+    return file && std::memcmp(magic, PointFileHeader::MAGIC, 8) == 0;
+  }
+
+  const PointFileHeader &header() const { return header_; }
+
+  CoordinateType type() const { return header_.type; }
+
+  size_t size() const { return header_.count; }
+
+  template <typename T> std::span<const T> xs() const {
+    return column<T>(sizeof(PointFileHeader));
+  }
+
+  template <typename T> std::span<const T> ys() const {
+    return column<T>(sizeof(PointFileHeader) + header_.columnBytes());
+  }
+
+  // Double columns as a view for the batch orientation kernel.
+  CoordView coords() const {
+    return {xs<double>().data(), ys<double>().data()};
+  }
+
+  // Points [begin, end) converted to T, whatever the stored type.
+  template <typename T = double>
+  std::vector<BasicPoint<T>> toPoints(size_t begin = 0,
+                                      size_t end = SIZE_MAX) const {
+    end = std::min<size_t>(end, size());
+    std::vector<BasicPoint<T>> points;
+    points.reserve(end > begin ? end - begin : 0);
+    auto convert = [&](auto tag) {
+      using S = decltype(tag);
+      auto xs = this->xs<S>();
+      auto ys = this->ys<S>();
+      for (size_t i = begin; i < end; ++i) {
+        points.emplace_back(static_cast<T>(xs[i]), static_cast<T>(ys[i]));
+      }
+    };
+    switch (type()) {
+    case CoordinateType::FLOAT:
+      convert(float{});
+      break;
+    case CoordinateType::DOUBLE:
+      convert(double{});
+      break;
+    case CoordinateType::INT32:
+      convert(int32_t{});
+      break;
+    case CoordinateType::INT64:
+      convert(int64_t{});
+      break;
+    }
+    return points;
+  }
+
+  // Drops the pages holding only points in [begin, end) of both columns.
+  void release(size_t begin, size_t end) const {
+    const size_t width = coordinateSize(type());
+    for (size_t offset : {sizeof(PointFileHeader),
+                          sizeof(PointFileHeader) + header_.columnBytes()}) {
+      file_.release(offset + begin * width, offset + end * width);
+    }
+  }
+
+private:
+  MappedFile file_;
+  PointFileHeader header_;
+
+  template <typename T> std::span<const T> column(size_t offset) const {
+    if (coordinateTypeOf<T>() != type()) {
+      throw std::invalid_argument("The file holds another coordinate type!");
+    }
+    return {reinterpret_cast<const T *>(file_.data() + offset), size()};
+  }
+};
+
+// Writes the points as a point file with coordinates of type T.
+template <typename T>
+void writePointFile(const std::string &path,
+                    std::span<const BasicPoint<T>> points) {
+  PointFileHeader header{};
+  std::memcpy(header.magic, PointFileHeader::MAGIC, 8);
+  header.version = PointFileHeader::VERSION;
+  header.type = coordinateTypeOf<T>();
+  header.count = points.size();
+  if (!points.empty()) {
+    header.min_x = header.max_x = static_cast<double>(points[0].x_);
+    header.min_y = header.max_y = static_cast<double>(points[0].y_);
+  }
+  for (const auto &point : points) {
+    header.min_x = std::min(header.min_x, static_cast<double>(point.x_));
+    header.min_y = std::min(header.min_y, static_cast<double>(point.y_));
+    header.max_x = std::max(header.max_x, static_cast<double>(point.x_));
+    header.max_y = std::max(header.max_y, static_cast<double>(point.y_));
+  }
+
+  std::ofstream file(path, std::ios::binary);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  const size_t padding = header.columnBytes() - points.size() * sizeof(T);
+  const char zeros[PointFileHeader::ALIGNMENT] = {};
+  std::vector<T> block;
+  for (bool y : {false, true}) {
+    for (size_t begin = 0; begin < points.size(); begin += 1 << 16) {
+      size_t end = std::min<size_t>(begin + (1 << 16), points.size());
+      block.clear();
+      for (size_t i = begin; i < end; ++i) {
+        block.push_back(y ? points[i].y_ : points[i].x_);
+      }
+      file.write(reinterpret_cast<const char *>(block.data()),
+                 block.size() * sizeof(T));
+    }
+    file.write(zeros, padding);
+  }
+  if (!file) {
+    throw std::runtime_error("Can't write " + path);
+  }
+}
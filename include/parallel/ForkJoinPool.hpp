@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Work-stealing pool for recursive fork/join parallelism. Each worker owns
+// a deque: invoke() pushes the second half of a fork at the bottom of the
+// caller's deque and runs the first half right away; the owner takes work
+// back from the bottom (newest, smallest) while idle workers steal from the
+// top of the others (oldest, largest). A join that finds its task stolen
+// runs other tasks until the thief is done, so nested forks can't deadlock
+// and no thread sleeps while there is work.
+//
+// Threads that aren't workers of the pool share one extra deque.
+class ForkJoinPool {
+public:
+  explicit ForkJoinPool(size_t threads = hardwareThreads()) {
+    threads = std::max<size_t>(1, threads);
+    for (size_t i = 0; i < threads; ++i) {
+      deques_.push_back(std::make_unique<Deque>());
+    }
+    // the last deque belongs to the callers, they are the last thread
+    for (size_t i = 0; i + 1 < threads; ++i) {
+      workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+  }
+
+  ForkJoinPool(const ForkJoinPool &) = delete;
+  ForkJoinPool &operator=(const ForkJoinPool &) = delete;
+
+  ~ForkJoinPool() {
+    {
+      std::lock_guard<std::mutex> lock(sleep_mutex_);
+      stop_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Worker threads plus the calling thread.
+  size_t size() const { return deques_.size(); }
+
+  // Pool sized to the machine, created on first use.
+  static ForkJoinPool &shared() {
+    static ForkJoinPool pool;
+    return pool;
+  }
+
+  static size_t hardwareThreads() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  // Runs a() and b(), possibly in parallel, and returns when both are done.
+  // An exception thrown by either is rethrown after both have finished.
+  template <typename A, typename B> void invoke(A &&a, B &&b) {
+    if (size() == 1) {
+      a();
+      b();
+      return;
+    }
+    Task task;
+    task.context = &b;
+    task.run = [](void *context) {
+      (*static_cast<std::remove_reference_t<B> *>(context))();
+    };
+    const size_t self = currentDeque();
+    push(self, &task);
+
+    std::exception_ptr error;
+    try {
+      a();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    if (popIf(self, &task)) {
+      execute(&task);
+    } else {
+      // stolen: help with other work until the thief has finished it
+      while (!task.done.load(std::memory_order_acquire)) {
+        if (Task *other = find(self)) {
+          execute(other);
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    if (task.error) {
+      std::rethrow_exception(task.error);
+    }
+  }
+
+  // Calls fn(begin, end) on contiguous ranges of [0, count) no longer than
+  // `grain`, forked in halves.
+  template <typename Fn> void forEach(size_t count, size_t grain, Fn &&fn) {
+    forRange(0, count, std::max<size_t>(1, grain), fn);
+  }
+
+private:
+  struct Task {
+    void (*run)(void *) = nullptr;
+    void *context = nullptr;
+    std::atomic<bool> done{false};
+    std::exception_ptr error;
+  };
+
+  struct Deque {
+    std::mutex mutex;
+    std::deque<Task *> tasks;
+  };
+
+  std::vector<std::unique_ptr<Deque>> deques_;
+  std::vector<std::thread> workers_;
+  std::atomic<size_t> queued_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+  bool stop_ = false;
+
+  // Deque of the calling thread: its own for a worker of this pool, the
+  // shared callers' one otherwise.
+  size_t currentDeque() const {
+    if (worker_pool() == this) {
+      return worker_index();
+    }
+    return deques_.size() - 1;
+  }
+
+  static const ForkJoinPool *&worker_pool() {
+    thread_local const ForkJoinPool *pool = nullptr;
+    return pool;
+  }
+
+  static size_t &worker_index() {
+    thread_local size_t index = 0;
+    return index;
+  }
+
+  template <typename Fn>
+  void forRange(size_t begin, size_t end, size_t grain, Fn &fn) {
+    if (end - begin <= grain) {
+      if (begin < end) {
+        fn(begin, end);
+      }
+      return;
+    }
+    const size_t mid = begin + (end - begin) / 2;
+    invoke([&] { forRange(begin, mid, grain, fn); },
+           [&] { forRange(mid, end, grain, fn); });
+  }
+
+  void push(size_t deque, Task *task) {
+    {
+      std::lock_guard<std::mutex> lock(deques_[deque]->mutex);
+      deques_[deque]->tasks.push_back(task);
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+    // an empty critical section orders the count before a sleeper's check
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    sleep_cv_.notify_one();
+  }
+
+  // Takes the task back if it is still at the bottom of the deque.
+  bool popIf(size_t deque, Task *task) {
+    std::lock_guard<std::mutex> lock(deques_[deque]->mutex);
+    auto &tasks = deques_[deque]->tasks;
+    if (tasks.empty() || tasks.back() != task) {
+      return false;
+    }
+    tasks.pop_back();
+    queued_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // The newest task of the own deque, or the oldest of another one.
+  Task *find(size_t self) {
+    for (size_t k = 0; k < deques_.size(); ++k) {
+      const size_t victim = (self + k) % deques_.size();
+      std::lock_guard<std::mutex> lock(deques_[victim]->mutex);
+      auto &tasks = deques_[victim]->tasks;
+      if (tasks.empty()) {
+        continue;
+      }
+      Task *task;
+      if (k == 0) {
+        task = tasks.back();
+        tasks.pop_back();
+      } else {
+        task = tasks.front();
+        tasks.pop_front();
+      }
+      queued_.fetch_sub(1, std::memory_order_relaxed);
+      return task;
+    }
+    return nullptr;
+  }
+
+  static void execute(Task *task) {
+    try {
+      task->run(task->context);
+    } catch (...) {
+      task->error = std::current_exception();
+    }
+    task->done.store(true, std::memory_order_release);
+  }
+
+  void workerLoop(size_t index) {
+    worker_pool() = this;
+    worker_index() = index;
+    while (true) {
+      if (Task *task = find(index)) {
+        execute(task);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      sleep_cv_.wait(lock, [this] {
+        return stop_ || queued_.load(std::memory_order_acquire) > 0;
+      });
+      if (stop_ && queued_.load(std::memory_order_acquire) == 0) {
+        return;
+      }
+    }
+  }
+};
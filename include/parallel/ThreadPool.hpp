@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads with a single FIFO task queue.
+// parallelFor() blocks until all of its tasks are done and the calling
+// thread takes part in the work, so nested calls can't deadlock.
+class ThreadPool {
+public:
+  explicit ThreadPool(size_t threads = hardwareThreads()) {
+    for (size_t i = 0; i + 1 < threads; ++i) {
+      workers_.emplace_back([this] { workerLoop(); });
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  // Worker threads plus the calling thread.
+  size_t size() const { return workers_.size() + 1; }
+
+  // Pool sized to the machine, created on first use.
+  static ThreadPool &shared() {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  static size_t hardwareThreads() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+  }
+
+  // Calls fn(i) for every i in [0, count), split into at most `tasks`
+  // contiguous chunks.
+  template <typename Fn>
+  void parallelFor(size_t count, Fn &&fn, size_t tasks = 0) {
+    if (tasks == 0) {
+      tasks = size();
+    }
+    tasks = std::min(tasks, count);
+    if (tasks <= 1) {
+      for (size_t i = 0; i < count; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    std::mutex done_mutex;
+    std::condition_variable done_cv;
+    size_t remaining = tasks;
+    auto run_chunk = [&](size_t chunk) {
+      size_t begin = count * chunk / tasks;
+      size_t end = count * (chunk + 1) / tasks;
+      for (size_t i = begin; i < end; ++i) {
+        fn(i);
+      }
+      std::lock_guard<std::mutex> lock(done_mutex);
+      if (--remaining == 0) {
+        done_cv.notify_all();
+      }
+    };
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t chunk = 1; chunk < tasks; ++chunk) {
+        queue_.push([&run_chunk, chunk] { run_chunk(chunk); });
+      }
+    }
+    cv_.notify_all();
+
+    run_chunk(0);
+    // help with queued work instead of idling, then wait for the rest
+    while (runPending()) {
+    }
+    std::unique_lock<std::mutex> lock(done_mutex);
+    done_cv.wait(lock, [&] { return remaining == 0; });
+  }
+
+private:
+  std::vector<std::thread> workers_;
+  std::queue<std::function<void()>> queue_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stop_ = false;
+
+  bool runPending() {
+    std::function<void()> task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queue_.empty()) {
+        return false;
+      }
+      task = std::move(queue_.front());
+      queue_.pop();
+    }
+    task();
+    return true;
+  }
+
+  void workerLoop() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+        if (stop_ && queue_.empty()) {
+          return;
+        }
+        task = std::move(queue_.front());
+        queue_.pop();
+      }
+      task();
+    }
+  }
+};
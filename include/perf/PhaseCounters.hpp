@@ -0,0 +1,264 @@
+#pragma once
+
+#include "Trace.hpp"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters around the phases of an algorithm.
+//
+// The engines mark their phases with perf::Phase, which costs a load of a
+// thread-local pointer unless a PhaseProfiler is active on the thread:
+//   perf::PhaseProfiler profiler;
+//   {
+//     perf::ProfileScope scope(profiler);
+//     ChanConvexHull chan(points);
+//   }
+//   for (const auto &[name, counts] : profiler.phases()) ...
+//
+// The counters come from perf_event_open and count user space on the
+// calling thread only, so work handed to a thread pool is missed. When they
+// can't be opened (not Linux, perf_event_paranoid, a container or a virtual
+// machine without a PMU) the phases still get their calls and wall time,
+// and available() tells which counters are missing.
+namespace perf {
+
+enum Event { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, EVENTS };
+
+inline const char *eventName(Event event) {
+  static const char *names[EVENTS] = {"cycles", "instructions",
+                                      "cache_misses", "branch_misses"};
+  return names[event];
+}
+
+// The counters of this thread as one perf event group, read together.
+class PerfCounters {
+public:
+  PerfCounters() {
+#ifdef __linux__
+    static const uint64_t configs[EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int event = 0; event < EVENTS; ++event) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = configs[event];
+      attr.disabled = leader_ < 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                         PERF_FORMAT_TOTAL_TIME_RUNNING;
+      const int fd = static_cast<int>(
+          syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+      if (fd < 0) {
+        if (error_.empty()) {
+          error_ = std::string(eventName(Event(event))) + ": " +
+                   std::strerror(errno);
+        }
+        continue;
+      }
+      if (leader_ < 0) {
+        leader_ = fd;
+      }
+      fds_.push_back(fd);
+      slots_[event] = static_cast<int>(fds_.size()) - 1;
+    }
+    if (leader_ >= 0) {
+      ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    error_ = "perf_event_open needs Linux";
+#endif
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  ~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      close(fd);
+    }
+#endif
+  }
+
+  bool available(Event event) const { return slots_[event] >= 0; }
+
+  bool anyAvailable() const { return leader_ >= 0; }
+
+  // Why the first counter that couldn't be opened wasn't, empty if all were.
+  const std::string &error() const { return error_; }
+
+  // Current values, scaled up when the kernel multiplexed the group; zero
+  // for the missing counters.
+  std::array<uint64_t, EVENTS> read() const {
+    std::array<uint64_t, EVENTS> values{};
+#ifdef __linux__
+    if (leader_ < 0) {
+      return values;
+    }
+    // nr, time enabled, time running, then one value per counter
+    uint64_t buffer[3 + EVENTS] = {};
+    if (::read(leader_, buffer, sizeof(buffer)) <= 0 || buffer[2] == 0) {
+      return values;
+    }
+    const double scale = double(buffer[1]) / double(buffer[2]);
+    for (int event = 0; event < EVENTS; ++event) {
+      if (slots_[event] >= 0) {
+        values[event] = uint64_t(buffer[3 + slots_[event]] * scale);
+      }
+    }
+#endif
+    return values;
+  }
+
+private:
+  int leader_ = -1;
+  std::vector<int> fds_;
+  // position of each event's value in the group read, -1 when missing
+  std::array<int, EVENTS> slots_{-1, -1, -1, -1};
+  std::string error_;
+};
+
+struct Counts {
+  uint64_t calls = 0;
+  double time_ns = 0;
+  std::array<uint64_t, EVENTS> events{};
+};
+
+// Counts per phase, summed over every time the phase ran. A phase started
+// inside another is recorded as "outer/inner", and its counts are also part
+// of the outer phase.
+class PhaseProfiler {
+public:
+  const std::vector<std::pair<std::string, Counts>> &phases() const {
+    return phases_;
+  }
+
+  bool available(Event event) const { return counters_.available(event); }
+
+  const std::string &error() const { return counters_.error(); }
+
+  // The counters now, for measuring around the phases.
+  std::array<uint64_t, EVENTS> read() const { return counters_.read(); }
+
+  void clear() {
+    phases_.clear();
+    open_.clear();
+  }
+
+  void begin(const char *name) {
+    std::string path = open_.empty()
+                           ? std::string(name)
+                           : phases_[open_.back().phase].first + "/" + name;
+    size_t phase = 0;
+    while (phase < phases_.size() && phases_[phase].first != path) {
+      ++phase;
+    }
+    if (phase == phases_.size()) {
+      phases_.emplace_back(std::move(path), Counts{});
+    }
+    open_.push_back({phase, std::chrono::steady_clock::now(), {}});
+    // read last, so the bookkeeping above isn't counted
+    open_.back().events = counters_.read();
+  }
+
+  void end() {
+    const std::array<uint64_t, EVENTS> events = counters_.read();
+    const auto now = std::chrono::steady_clock::now();
+    const Open &open = open_.back();
+    Counts &counts = phases_[open.phase].second;
+    ++counts.calls;
+    counts.time_ns +=
+        std::chrono::duration<double, std::nano>(now - open.start).count();
+    for (int event = 0; event < EVENTS; ++event) {
+      counts.events[event] += events[event] - open.events[event];
+    }
+    open_.pop_back();
+  }
+
+private:
+  struct Open {
+    size_t phase;
+    std::chrono::steady_clock::time_point start;
+    std::array<uint64_t, EVENTS> events;
+  };
+
+  PerfCounters counters_;
+  std::vector<std::pair<std::string, Counts>> phases_;
+  std::vector<Open> open_;
+};
+
+// The profiler the phases of this thread go to, null when none.
+inline PhaseProfiler *&activeProfiler() {
+  thread_local PhaseProfiler *profiler = nullptr;
+  return profiler;
+}
+
+// Makes a profiler active on this thread for its lifetime.
+class ProfileScope {
+public:
+  explicit ProfileScope(PhaseProfiler &profiler)
+      : previous_(std::exchange(activeProfiler(), &profiler)) {}
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+  ~ProfileScope() { activeProfiler() = previous_; }
+
+private:
+  PhaseProfiler *previous_;
+};
+
+// One phase of an algorithm, from construction to destruction or end().
+// With HULL_TRACE it is also a trace scope.
+class Phase {
+public:
+  explicit Phase(const char *name)
+      : profiler_(activeProfiler())
+#ifdef HULL_TRACE
+        ,
+        scope_(name)
+#endif
+  {
+    if (profiler_ != nullptr) {
+      profiler_->begin(name);
+    }
+  }
+
+  Phase(const Phase &) = delete;
+  Phase &operator=(const Phase &) = delete;
+
+  ~Phase() { end(); }
+
+  void end() {
+#ifdef HULL_TRACE
+    scope_.end();
+#endif
+    if (profiler_ != nullptr) {
+      profiler_->end();
+      profiler_ = nullptr;
+    }
+  }
+
+private:
+  PhaseProfiler *profiler_;
+#ifdef HULL_TRACE
+  trace::Scope scope_;
+#endif
+};
+
+} // namespace perf
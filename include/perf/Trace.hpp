@@ -0,0 +1,226 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+// Timeline tracing of a run: scoped phase timings and operation counters,
+// recorded into a ring buffer per thread and written out as Chrome trace
+// JSON, which chrome://tracing and ui.perfetto.dev open.
+//
+// The engines trace through the TRACE_SCOPE and TRACE_COUNT macros, which
+// expand to nothing unless the build defines HULL_TRACE, so an untraced
+// build has no trace code at all in the engines. The perf::Phase scopes
+// (PhaseCounters.hpp) are traced as well.
+//   g++ -DHULL_TRACE ...
+//   ChanConvexHull chan(points);
+//   std::ofstream out("trace.json");
+//   trace::writeChromeJson(out);
+//
+// A full ring buffer overwrites its oldest scopes. writeChromeJson() and
+// clear() must not run while traced threads are still recording.
+namespace trace {
+
+enum Counter {
+  // every orientation predicate, whichever engine or policy calls it
+  ORIENTATION_TESTS,
+  // Chan's finger and binary searches for a sub-hull's tangent
+  TANGENT_SEARCHES,
+  WRAPPING_STEPS,
+  GRAHAM_POPS,
+  COUNTERS
+};
+
+inline const char *counterName(Counter counter) {
+  static const char *names[COUNTERS] = {"orientation_tests",
+                                        "tangent_searches", "wrapping_steps",
+                                        "graham_pops"};
+  return names[counter];
+}
+
+inline uint64_t now() {
+  static const auto epoch = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - epoch)
+      .count();
+}
+
+// A finished scope, with this thread's counters at its end.
+struct Event {
+  const char *name;
+  uint64_t start_ns;
+  uint64_t duration_ns;
+  std::array<uint64_t, COUNTERS> counters;
+};
+
+class ThreadBuffer {
+public:
+  ThreadBuffer(uint32_t thread, size_t capacity)
+      : thread_{thread}, events_(capacity) {}
+
+  void push(const Event &event) {
+    events_[next_] = event;
+    if (++next_ == events_.size()) {
+      next_ = 0;
+    }
+    ++recorded_;
+  }
+
+  void clear() {
+    next_ = 0;
+    recorded_ = 0;
+    counters_ = {};
+  }
+
+  uint32_t thread() const { return thread_; }
+
+  // Oldest first.
+  template <typename Visit> void forEach(Visit &&visit) const {
+    const size_t kept = std::min<uint64_t>(recorded_, events_.size());
+    const size_t first = recorded_ > events_.size() ? next_ : 0;
+    for (size_t i = 0; i < kept; ++i) {
+      visit(events_[(first + i) % events_.size()]);
+    }
+  }
+
+  uint64_t dropped() const {
+    return recorded_ > events_.size() ? recorded_ - events_.size() : 0;
+  }
+
+  std::array<uint64_t, COUNTERS> &counters() { return counters_; }
+
+private:
+  uint32_t thread_;
+  std::vector<Event> events_;
+  size_t next_ = 0;
+  uint64_t recorded_ = 0;
+  std::array<uint64_t, COUNTERS> counters_{};
+};
+
+namespace detail {
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  size_t capacity = size_t{1} << 16;
+};
+
+inline Registry &registry() {
+  static Registry registry;
+  return registry;
+}
+
+} // namespace detail
+
+// Scopes each thread keeps, for the threads that haven't traced yet.
+inline void setCapacity(size_t events) {
+  detail::Registry &registry = detail::registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.capacity = std::max<size_t>(events, 1);
+}
+
+// This thread's buffer, registered on first use and kept by the registry
+// after the thread ends.
+inline ThreadBuffer &threadBuffer() {
+  thread_local ThreadBuffer *buffer = [] {
+    detail::Registry &registry = detail::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.buffers.push_back(std::make_shared<ThreadBuffer>(
+        static_cast<uint32_t>(registry.buffers.size() + 1),
+        registry.capacity));
+    return registry.buffers.back().get();
+  }();
+  return *buffer;
+}
+
+inline void count(Counter counter, uint64_t amount = 1) {
+  threadBuffer().counters()[counter] += amount;
+}
+
+class Scope {
+public:
+  explicit Scope(const char *name) : name_{name}, start_{now()} {}
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+  ~Scope() { end(); }
+
+  void end() {
+    if (name_ == nullptr) {
+      return;
+    }
+    ThreadBuffer &buffer = threadBuffer();
+    buffer.push({name_, start_, now() - start_, buffer.counters()});
+    name_ = nullptr;
+  }
+
+private:
+  const char *name_;
+  uint64_t start_;
+};
+
+inline void clear() {
+  detail::Registry &registry = detail::registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (const auto &buffer : registry.buffers) {
+    buffer->clear();
+  }
+}
+
+// Every scope as a complete ("X") event on its thread, followed by a
+// counter ("C") event with the thread's counters at its end. Times are in
+// microseconds, as the format wants.
+inline void writeChromeJson(std::ostream &out) {
+  detail::Registry &registry = detail::registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  const auto precision = out.precision(15);
+  out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+  bool first = true;
+  uint64_t dropped = 0;
+  for (const auto &buffer : registry.buffers) {
+    const uint32_t tid = buffer->thread();
+    out << (first ? "\n" : ",\n")
+        << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+        << tid << ", \"args\": {\"name\": \"thread " << tid << "\"}}";
+    first = false;
+    buffer->forEach([&](const Event &event) {
+      const double start_us = event.start_ns / 1000.0;
+      const double end_us = (event.start_ns + event.duration_ns) / 1000.0;
+      out << ",\n{\"name\": \"" << event.name
+          << "\", \"cat\": \"hull\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+          << tid << ", \"ts\": " << start_us
+          << ", \"dur\": " << event.duration_ns / 1000.0 << "}";
+      out << ",\n{\"name\": \"counters (thread " << tid
+          << ")\", \"ph\": \"C\", \"pid\": 1, \"tid\": " << tid
+          << ", \"ts\": " << end_us << ", \"args\": {";
+      for (int counter = 0; counter < COUNTERS; ++counter) {
+        out << (counter > 0 ? ", \"" : "\"")
+            << counterName(Counter(counter))
+            << "\": " << event.counters[counter];
+      }
+      out << "}}";
+    });
+    dropped += buffer->dropped();
+  }
+  out << "\n], \"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+  out.precision(precision);
+}
+
+} // namespace trace
+
+#ifdef HULL_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name)                                                      \
+  ::trace::Scope TRACE_CONCAT(trace_scope_, __LINE__)(name)
+#define TRACE_COUNT(counter, amount) ::trace::count(::trace::counter, amount)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_COUNT(counter, amount) ((void)0)
+#endif
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "../algorithm/Point.hpp"
+#include "../perf/Trace.hpp"
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HULL_SIMD_X86 1
+#endif
+
+static_assert(sizeof(Point) == 2 * sizeof(double),
+              "Point must be two packed doubles to be read as coordinates");
+
+// Coordinates of a run of points: point i is (x[i * stride], y[i * stride]).
+// stride 1 reads separate x[] and y[] columns, stride 2 an array of Point.
+struct CoordView {
+  const double *x = nullptr;
+  const double *y = nullptr;
+  size_t stride = 1;
+
+  CoordView() = default;
+
+  CoordView(const double *xs, const double *ys, size_t step = 1)
+      : x{xs}, y{ys}, stride{step} {}
+
+  explicit CoordView(const Point *points)
+      : x{points ? &points->x_ : nullptr}, y{points ? &points->y_ : nullptr},
+        stride{2} {}
+
+  Point operator[](size_t i) const {
+    return {x[i * stride], y[i * stride]};
+  }
+};
+
+// Batched orientation test of many points against one directed edge:
+// out[i - begin] = cross(a, b, p_i) for i in [begin, end), positive when p_i
+// is left of (a, b). The instruction set is picked at runtime. Every path
+// evaluates the same expression as the scalar cross products of the engines,
+// in the same order and without FMA.
+namespace simd {
+
+enum class Isa { SCALAR, SSE2, AVX2 };
+
+inline const char *isaName(Isa isa) {
+  switch (isa) {
+  case Isa::AVX2:
+    return "avx2";
+  case Isa::SSE2:
+    return "sse2";
+  default:
+    return "scalar";
+  }
+}
+
+inline Isa detectIsa() {
+#ifdef HULL_SIMD_X86
+  if (__builtin_cpu_supports("avx2")) {
+    return Isa::AVX2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return Isa::SSE2;
+  }
+#endif
+  return Isa::SCALAR;
+}
+
+// Instruction set in use, detected once; setIsa() can force a lower one
+// for benchmarking.
+inline Isa &activeIsa() {
+  static Isa isa = detectIsa();
+  return isa;
+}
+
+inline void setIsa(Isa isa) {
+  if (static_cast<int>(isa) <= static_cast<int>(detectIsa())) {
+    activeIsa() = isa;
+  }
+}
+
+inline void orientationScalar(CoordView points, size_t begin, size_t end,
+                              const Point &a, const Point &b, double *out) {
+  const double ex = b.x_ - a.x_;
+  const double ey = b.y_ - a.y_;
+  for (size_t i = begin; i < end; ++i) {
+    const double px = points.x[i * points.stride];
+    const double py = points.y[i * points.stride];
+    out[i - begin] = ex * (py - a.y_) - ey * (px - a.x_);
+  }
+}
+
+#ifdef HULL_SIMD_X86
+__attribute__((target("sse2"))) inline void
+orientationSse2(CoordView points, size_t begin, size_t end, const Point &a,
+                const Point &b, double *out) {
+  const __m128d ax = _mm_set1_pd(a.x_);
+  const __m128d ay = _mm_set1_pd(a.y_);
+  const __m128d ex = _mm_set1_pd(b.x_ - a.x_);
+  const __m128d ey = _mm_set1_pd(b.y_ - a.y_);
+  size_t i = begin;
+  for (; i + 2 <= end; i += 2) {
+    __m128d px;
+    __m128d py;
+    if (points.stride == 1) {
+      px = _mm_loadu_pd(points.x + i);
+      py = _mm_loadu_pd(points.y + i);
+    } else {
+      // (x0, y0), (x1, y1) -> (x0, x1), (y0, y1)
+      __m128d p0 = _mm_loadu_pd(points.x + i * 2);
+      __m128d p1 = _mm_loadu_pd(points.x + i * 2 + 2);
+      px = _mm_unpacklo_pd(p0, p1);
+      py = _mm_unpackhi_pd(p0, p1);
+    }
+    __m128d cross = _mm_sub_pd(_mm_mul_pd(ex, _mm_sub_pd(py, ay)),
+                               _mm_mul_pd(ey, _mm_sub_pd(px, ax)));
+    _mm_storeu_pd(out + (i - begin), cross);
+  }
+  orientationScalar(points, i, end, a, b, out + (i - begin));
+}
+
+__attribute__((target("avx2"))) inline void
+orientationAvx2(CoordView points, size_t begin, size_t end, const Point &a,
+                const Point &b, double *out) {
+  const __m256d ax = _mm256_set1_pd(a.x_);
+  const __m256d ay = _mm256_set1_pd(a.y_);
+  const __m256d ex = _mm256_set1_pd(b.x_ - a.x_);
+  const __m256d ey = _mm256_set1_pd(b.y_ - a.y_);
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    __m256d px;
+    __m256d py;
+    if (points.stride == 1) {
+      px = _mm256_loadu_pd(points.x + i);
+      py = _mm256_loadu_pd(points.y + i);
+    } else {
+      // (x0, y0, x1, y1), (x2, y2, x3, y3) -> (x0, x2, x1, x3) and
+      // (y0, y2, y1, y3), then lanes 1 and 2 are swapped back
+      __m256d p01 = _mm256_loadu_pd(points.x + i * 2);
+      __m256d p23 = _mm256_loadu_pd(points.x + i * 2 + 4);
+      px = _mm256_permute4x64_pd(_mm256_unpacklo_pd(p01, p23), 0b11011000);
+      py = _mm256_permute4x64_pd(_mm256_unpackhi_pd(p01, p23), 0b11011000);
+    }
+    __m256d cross = _mm256_sub_pd(_mm256_mul_pd(ex, _mm256_sub_pd(py, ay)),
+                                  _mm256_mul_pd(ey, _mm256_sub_pd(px, ax)));
+    _mm256_storeu_pd(out + (i - begin), cross);
+  }
+  orientationScalar(points, i, end, a, b, out + (i - begin));
+}
+#endif
+
+inline void orientationBatch(CoordView points, size_t begin, size_t end,
+                             const Point &a, const Point &b, double *out) {
+  TRACE_COUNT(ORIENTATION_TESTS, end - begin);
+#ifdef HULL_SIMD_X86
+  switch (activeIsa()) {
+  case Isa::AVX2:
+    orientationAvx2(points, begin, end, a, b, out);
+    return;
+  case Isa::SSE2:
+    orientationSse2(points, begin, end, a, b, out);
+    return;
+  default:
+    break;
+  }
+#endif
+  orientationScalar(points, begin, end, a, b, out);
+}
+
+} // namespace simd
@@ -0,0 +1,124 @@
+#include "../include/algorithm/ChanConvexHull.hpp"
+#include "../include/algorithm/PointSet.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <malloc.h>
+#include <new>
+#include <string>
+#include <vector>
+
+// Heap allocations and peak heap of Chan, kept out of stats.cpp because it
+// replaces the global operator new and delete: every allocation of this
+// program is counted, and the other benchmarks shouldn't pay for that.
+namespace heap {
+
+std::atomic<size_t> allocations{0};
+std::atomic<size_t> live{0};
+std::atomic<size_t> peak{0};
+
+// Starts counting allocations and the peak from here.
+void reset() {
+  allocations = 0;
+  peak = live.load();
+}
+
+void *allocate(size_t size, size_t alignment) {
+  if (size == 0) {
+    size = 1;
+  }
+  void *pointer = alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__
+                      ? std::malloc(size)
+                      : std::aligned_alloc(
+                            alignment, (size + alignment - 1) / alignment *
+                                           alignment);
+  if (pointer == nullptr) {
+    throw std::bad_alloc();
+  }
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  const size_t usable = malloc_usable_size(pointer);
+  const size_t now = live.fetch_add(usable, std::memory_order_relaxed) + usable;
+  size_t seen = peak.load(std::memory_order_relaxed);
+  while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+  }
+  return pointer;
+}
+
+// Takes the pointer as an integer, so the compiler doesn't pair the free
+// below with the operator new it came from and warn about a mismatch.
+void release(uintptr_t address) {
+  void *pointer = reinterpret_cast<void *>(address);
+  if (pointer != nullptr) {
+    live.fetch_sub(malloc_usable_size(pointer), std::memory_order_relaxed);
+    std::free(pointer);
+  }
+}
+
+} // namespace heap
+
+void *operator new(size_t size) { return heap::allocate(size, 0); }
+
+void *operator new(size_t size, std::align_val_t alignment) {
+  return heap::allocate(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void *pointer) noexcept {
+  heap::release(reinterpret_cast<uintptr_t>(pointer));
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+  heap::release(reinterpret_cast<uintptr_t>(pointer));
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+  heap::release(reinterpret_cast<uintptr_t>(pointer));
+}
+
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept {
+  heap::release(reinterpret_cast<uintptr_t>(pointer));
+}
+
+// Heap allocations and peak heap of Chan (one thread) on random points
+// and on points of a circle, where the hull has every point and takes the
+// most rounds. The size of the input can be passed as the first argument.
+int main(int argc, char *argv[]) {
+  const size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  const std::string csv_path = "chan_memory.csv";
+
+  PointSet random_set;
+  random_set.generate_points(n);
+  PointSet circle_set;
+  circle_set.generate_circular_points(n / 10);
+  const std::vector<std::pair<std::string, const PointSet *>> inputs{
+      {"random", &random_set}, {"circle", &circle_set}};
+
+  std::ofstream outfile(csv_path);
+  outfile << "input,n,time_ms,rounds,allocations,peak_heap_mib\n";
+  for (const auto &[name, point_set] : inputs) {
+    const std::vector<Point> &points = point_set->get_set();
+    const size_t base = heap::live.load();
+    heap::reset();
+    auto start = std::chrono::high_resolution_clock::now();
+    ChanConvexHull chan(points);
+    auto end = std::chrono::high_resolution_clock::now();
+    const size_t allocations = heap::allocations.load();
+    const double peak = (heap::peak.load() - base) / (1024.0 * 1024.0);
+    double time_ms =
+        std::chrono::duration<double, std::milli>(end - start).count();
+
+    outfile << name << "," << points.size() << "," << time_ms << ","
+            << chan.getRounds() << "," << allocations << "," << peak << "\n";
+    std::cout << std::left << std::setw(7) << name << std::right
+              << " n=" << points.size() << " | " << time_ms << "ms"
+              << " | rounds: " << chan.getRounds()
+              << " | allocations: " << allocations << " | peak heap: " << peak
+              << " MiB" << std::endl;
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+  return 0;
+}
@@ -1,56 +1,60 @@
-import pandas as pd
-import matplotlib.pyplot as plt
-import numpy as np
-
-# Load data
-df = pd.read_csv('timings.csv')
+import json
+import sys
 
-# Calculate mean and standard deviation
-stats = df.groupby('n').agg({
-    'jarvis_time': ['mean', 'std'],
-    'graham_time': ['mean', 'std'],
-    'chan_time': ['mean', 'std']
-}).reset_index()
+import matplotlib.pyplot as plt
+import pandas as pd
 
-# Flatten column names
-stats.columns = ['n', 
-                'jarvis_mean', 'jarvis_std',
-                'graham_mean', 'graham_std',
-                'chan_mean', 'chan_std']
+# Load the results written by the benchmark harness (./stats), any engines
+# and distributions it was run with
+path = sys.argv[1] if len(sys.argv) > 1 else 'results.json'
+with open(path) as results_file:
+    results = json.load(results_file)
+df = pd.DataFrame(results['results'])
 
-# Create plot
-plt.figure(figsize=(10, 6))
+# Times in microseconds
+for column in ['min_ns', 'median_ns', 'p95_ns', 'p99_ns']:
+    df[column.replace('_ns', '_us')] = df[column] / 1000
 
-# Plot with error bars
-plt.errorbar(stats['n'], stats['jarvis_mean'], yerr=stats['jarvis_std'], 
-             fmt='o-', capsize=5, label='Jarvis')
-plt.errorbar(stats['n'], stats['graham_mean'], yerr=stats['graham_std'], 
-             fmt='s-', capsize=5, label='Graham')
-plt.errorbar(stats['n'], stats['chan_mean'], yerr=stats['chan_std'], 
-             fmt='^-', capsize=5, label='Chan')
+distributions = list(dict.fromkeys(df['distribution']))
+markers = ['o-', 's-', '^-', 'd-', 'v-', 'p-', 'h-', '*-']
 
-# Formatting
-plt.xscale('log')
-plt.yscale('log')
-plt.xlabel('Number of Points (log scale)')
-plt.ylabel('Execution Time (μs, log scale)')
-plt.title('Convex Hull Algorithm Performance')
-plt.legend()
-plt.grid(True, which="both", ls="--")
-plt.savefig('performance_comparison.png', dpi=300)
+# One panel per distribution: the median with the error bar reaching from
+# the fastest run to the 95th percentile
+fig, axes = plt.subplots(1, len(distributions), squeeze=False,
+                         figsize=(10 * len(distributions), 6))
+for ax, distribution in zip(axes[0], distributions):
+    subset = df[df['distribution'] == distribution]
+    for marker, (engine, rows) in zip(markers * 2, subset.groupby('engine', sort=False)):
+        rows = rows.sort_values('n')
+        ax.errorbar(rows['n'], rows['median_us'],
+                    yerr=[rows['median_us'] - rows['min_us'],
+                          rows['p95_us'] - rows['median_us']],
+                    fmt=marker, capsize=5, label=engine)
+    ax.set_xscale('log')
+    ax.set_yscale('log')
+    ax.set_xlabel('Number of Points (log scale)')
+    ax.set_ylabel('Median Time (μs, log scale)')
+    ax.set_title(f'Convex Hull Algorithm Performance ({distribution})')
+    ax.legend()
+    ax.grid(True, which="both", ls="--")
+fig.tight_layout()
+fig.savefig('performance_comparison.png', dpi=300)
 plt.show()
 
-# Additional plot for large n
-plt.figure(figsize=(10, 6))
-large_n = stats[stats['n'] > 1000]  # Focus on larger datasets
-for algo in ['jarvis', 'graham', 'chan']:
-    plt.plot(large_n['n'], large_n[f'{algo}_mean'], 'o-', 
-             label=algo.capitalize())
-    
-plt.xlabel('Number of Points')
-plt.ylabel('Time (μs)')
-plt.title('Performance on Large Datasets')
-plt.legend()
-plt.grid(True)
-plt.savefig('large_n_performance.png', dpi=300)
+# Additional plot for large n, with the tail latency
+fig, axes = plt.subplots(1, len(distributions), squeeze=False,
+                         figsize=(10 * len(distributions), 6))
+for ax, distribution in zip(axes[0], distributions):
+    subset = df[(df['distribution'] == distribution) & (df['n'] > 1000)]
+    for marker, (engine, rows) in zip(markers * 2, subset.groupby('engine', sort=False)):
+        rows = rows.sort_values('n')
+        line, = ax.plot(rows['n'], rows['median_us'], marker, label=engine)
+        ax.plot(rows['n'], rows['p99_us'], ':', color=line.get_color())
+    ax.set_xlabel('Number of Points')
+    ax.set_ylabel('Time (μs, median solid, p99 dotted)')
+    ax.set_title(f'Performance on Large Datasets ({distribution})')
+    ax.legend()
+    ax.grid(True)
+fig.tight_layout()
+fig.savefig('large_n_performance.png', dpi=300)
 plt.show()
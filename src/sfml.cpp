@@ -1,3 +1,4 @@
+#include "../include/algorithm/ConvexHullBase.hpp"
 #include "../include/algorithm/ChanConvexHull.hpp"
 #include "../include/algorithm/GrahamConvexHull.hpp"
 #include "../include/algorithm/JarvisConvexHull.hpp"
@@ -6,6 +7,8 @@
 #include <SFML/Graphics.hpp>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <utility>
 
 const sf::Color BACKGROUND_COLOR(51, 52, 70);
 const sf::Color BORDER_COLOR(40, 42, 54);
@@ -18,8 +21,10 @@ const sf::Color TEXT_COLOR(248, 248, 242);
 
 class ConvexHullVisualizer {
 public:
-  ConvexHullVisualizer()
-      : nextButton("New points", font, {20, SF_HEIGHT - 70}, {200, 50}),
+  // path : points to show first (CSV or point file), random ones if empty
+  explicit ConvexHullVisualizer(std::string path = {})
+      : pointsPath{std::move(path)},
+        nextButton("New points", font, {20, SF_HEIGHT - 70}, {200, 50}),
         toggleMeshButton("Toggle mesh", font, {240, SF_HEIGHT - 70},
                          {200, 50}) {
     sf::ContextSettings settings;
@@ -45,6 +50,7 @@ public:
   }
 
 private:
+  std::string pointsPath;
   sf::RenderWindow window;
   sf::Font font;
   Button nextButton;
@@ -117,16 +123,30 @@ private:
     //               {1480.36, 667.363}, {178.496, 128.064}, {881.097, 140.504},
     //               {1701.36, 171.9},   {1368.94, 875.067}, {557.874, 717.462},
     //               {685.26, 891.958}});
-    pointSet.generate_points();
+    if (pointsPath.empty()) {
+      pointSet.generate_points();
+    } else {
+      // recorded points come once, "New points" goes back to random sets
+      pointSet.load(pointsPath);
+      pointSet.fit_into();
+      pointsPath.clear();
+    }
     initializeHullAlgorithm();
     createVisualElements();
   }
 
   void initializeHullAlgorithm() {
-    hullAlgorithm = std::make_unique<ChanConvexHull>(pointSet.get_set());
-    // hullAlgorithm = std::make_unique<GrahamConvexHull>(pointSet.get_set());
-    // hullAlgorithm = std::make_unique<JarvisConvexHull>(pointSet.get_set());
-    // hullAlgorithm2 = std::make_unique<JarvisConvexHull>(pointSet.get_set());
+    hullAlgorithm =
+        std::make_unique<ConvexHullAdapter<ChanConvexHull>>(pointSet.get_set());
+    // hullAlgorithm = std::make_unique<ConvexHullAdapter<GrahamConvexHull>>(
+    //     pointSet.get_set());
+    // hullAlgorithm = std::make_unique<ConvexHullAdapter<JarvisConvexHull>>(
+    //     pointSet.get_set());
+    // hullAlgorithm =
+    //     std::make_unique<ConvexHullAdapter<MonotoneChainConvexHull>>(
+    //         pointSet.get_set());
+    // hullAlgorithm2 = std::make_unique<ConvexHullAdapter<JarvisConvexHull>>(
+    //     pointSet.get_set());
     // std::vector<Point> res1 = hullAlgorithm->getHull();
     // std::vector<Point> res2 = hullAlgorithm2->getHull();
     // assert(res1.size() == res2.size());
@@ -147,7 +167,7 @@ private:
     for (const auto &point : pointSet.get_set()) {
       sf::CircleShape circle(SF_POINT_RADIUS);
       circle.setPointCount(32);
-      if (point == hullAlgorithm->getHull()[0]) {
+      if (i == hullAlgorithm->getHullIndices()[0]) {
         circle.setFillColor(START_POINT_COLOR);
       } else {
         circle.setFillColor(REGULAR_POINT_COLOR);
@@ -157,11 +177,14 @@ private:
       circle.setPosition(point.x_ - SF_POINT_RADIUS,
                          point.y_ - SF_POINT_RADIUS);
       points.push_back(std::move(circle));
+      ++i;
     }
   }
 
   void createPartitionMeshes() {
-    if (auto chanHull = dynamic_cast<ChanConvexHull *>(hullAlgorithm.get())) {
+    if (auto chanAdapter = dynamic_cast<ConvexHullAdapter<ChanConvexHull> *>(
+            hullAlgorithm.get())) {
+      const ChanConvexHull *chanHull = &chanAdapter->engine();
       partitionMeshes.clear();
       size_t partitions = chanHull->getPartitionsNumber();
       partitionMeshes.resize(partitions);
@@ -170,7 +193,7 @@ private:
       const sf::Color endColor(180, 120, 255);
 
       for (size_t i = 0; i < partitions; ++i) {
-        const auto &polygon = chanHull->getGrahamPartition(i);
+        const auto &polygon = chanHull->getPartitionHull(i);
         partitionMeshes[i] = sf::VertexArray(sf::LineStrip, polygon.size() + 1);
         float ratio =
             partitions > 1 ? static_cast<float>(i) / (partitions - 1) : 0.5f;
@@ -282,8 +305,8 @@ private:
   }
 };
 
-int main() {
-  ConvexHullVisualizer visualizer;
+int main(int argc, char *argv[]) {
+  ConvexHullVisualizer visualizer(argc > 1 ? argv[1] : "");
   visualizer.run();
   return EXIT_SUCCESS;
 }
@@ -1,50 +1,53 @@
+#include "../include/algorithm/ApproximateConvexHull.hpp"
+#include "../include/algorithm/BatchConvexHull.hpp"
 #include "../include/algorithm/ChanConvexHull.hpp"
+#include "../include/algorithm/ConvexPolygonIndex.hpp"
+#include "../include/algorithm/DivideConquerConvexHull.hpp"
 #include "../include/algorithm/GrahamConvexHull.hpp"
+#include "../include/algorithm/IncrementalConvexHull.hpp"
 #include "../include/algorithm/JarvisConvexHull.hpp"
+#include "../include/algorithm/MonotoneChainConvexHull.hpp"
+#include "../include/algorithm/OutOfCoreConvexHull.hpp"
+#include "../include/algorithm/QuickHullConvexHull.hpp"
+#include "../include/algorithm/RotatingCalipers.hpp"
 #include "../include/algorithm/PointSet.hpp"
+#include "../include/algorithm/SlidingWindowConvexHull.hpp"
+#include "../include/bench/Distributions.hpp"
+#include "../include/bench/Harness.hpp"
+#include "../include/io/CsvPoints.hpp"
+#include "../include/io/PointFile.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <random>
+#include <sstream>
+#include <string>
 #include <vector>
 
-int main() {
-  // Configuration
-  bool circular = false;
-  const std::vector<size_t> sizes_random{100,   500,   1000, 5000,
-                                         10000, 25000, 50000};
-  const std::vector<size_t> sizes_circular{100, 200, 300, 400, 500, 600, 700};
-  std::vector<size_t> sizes;
-  if (circular) {
-    sizes = sizes_circular;
-  } else {
-    sizes = sizes_random;
-  }
-  const int trials = 5; // Runs per size
-  const std::string csv_path = "timings.csv";
+// Graham and the monotone chain on inputs far too large for Jarvis, to
+// check O(n log n).
+void graham_scaling() {
+  const std::vector<size_t> sizes{100000, 1000000, 10000000};
+  const int trials = 5;
+  const std::string csv_path = "graham_scaling.csv";
 
   std::ofstream outfile(csv_path);
-  outfile << "n,trial,jarvis_time,graham_time,chan_time\n";
+  outfile << "n,trial,graham_time,monotone_time\n";
 
   for (size_t n : sizes) {
     for (int t = 0; t < trials; ++t) {
-      // Generate new point set
       PointSet point_set;
+      point_set.generate_points(n);
 
-      if (circular) {
-        point_set.generate_circular_points(n);
-      } else {
-        point_set.generate_points(n);
-      }
-
-      // Measure Jarvis
-      auto start_jarvis = std::chrono::high_resolution_clock::now();
-      JarvisConvexHull jarvis(point_set.get_set());
-      auto end_jarvis = std::chrono::high_resolution_clock::now();
-      long jarvis_time = std::chrono::duration_cast<std::chrono::microseconds>(
-                             end_jarvis - start_jarvis)
-                             .count();
-
-      // Measure Graham
       auto start_graham = std::chrono::high_resolution_clock::now();
       GrahamConvexHull graham(point_set.get_set());
       auto end_graham = std::chrono::high_resolution_clock::now();
@@ -52,30 +55,1664 @@ int main() {
                              end_graham - start_graham)
                              .count();
 
-      // Measure Chan
+      auto start_monotone = std::chrono::high_resolution_clock::now();
+      MonotoneChainConvexHull monotone(point_set.get_set());
+      auto end_monotone = std::chrono::high_resolution_clock::now();
+      long monotone_time =
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              end_monotone - start_monotone)
+              .count();
+
+      outfile << n << "," << t << "," << graham_time << "," << monotone_time
+              << "\n";
+      std::cout << "n=" << n << " trial=" << t << " | Graham: " << graham_time
+                << "μs (" << static_cast<double>(graham_time) * 1000 / n
+                << "ns/pt)"
+                << " | Monotone: " << monotone_time << "μs ("
+                << static_cast<double>(monotone_time) * 1000 / n << "ns/pt)"
+                << std::endl;
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Builds a hull of type Hull and returns the elapsed time in microseconds,
+// the number of points left after the pre-filter goes to `processed`.
+template <typename Hull>
+long measure(const std::vector<Point> &points, Prefilter prefilter,
+             size_t &processed) {
+  auto start = std::chrono::high_resolution_clock::now();
+  Hull hull(points, prefilter);
+  auto end = std::chrono::high_resolution_clock::now();
+  processed = hull.processedSize();
+  return std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+      .count();
+}
+
+// Every engine with and without the Akl–Toussaint octagon filter. Times
+// include the filtering pass, so the ratio is the end-to-end speedup.
+void prefilter_comparison() {
+  const std::vector<size_t> sizes{1000, 10000, 100000, 1000000};
+  const int trials = 5;
+  const std::string csv_path = "prefilter.csv";
+
+  std::ofstream outfile(csv_path);
+  outfile << "n,trial,survivors,jarvis_time,jarvis_filtered_time,graham_time,"
+             "graham_filtered_time,chan_time,chan_filtered_time,"
+             "monotone_time,monotone_filtered_time\n";
+
+  for (size_t n : sizes) {
+    for (int t = 0; t < trials; ++t) {
+      PointSet point_set;
+      point_set.generate_points(n);
+      const auto &points = point_set.get_set();
+
+      size_t processed = 0;
+      size_t survivors = 0;
+      long jarvis_time = measure<JarvisConvexHull>(points, Prefilter::NONE,
+                                                   processed);
+      long jarvis_filtered_time = measure<JarvisConvexHull>(
+          points, Prefilter::OCTAGON, survivors);
+      long graham_time = measure<GrahamConvexHull>(points, Prefilter::NONE,
+                                                   processed);
+      long graham_filtered_time = measure<GrahamConvexHull>(
+          points, Prefilter::OCTAGON, processed);
+      long chan_time =
+          measure<ChanConvexHull>(points, Prefilter::NONE, processed);
+      long chan_filtered_time =
+          measure<ChanConvexHull>(points, Prefilter::OCTAGON, processed);
+      long monotone_time = measure<MonotoneChainConvexHull>(
+          points, Prefilter::NONE, processed);
+      long monotone_filtered_time = measure<MonotoneChainConvexHull>(
+          points, Prefilter::OCTAGON, processed);
+
+      outfile << n << "," << t << "," << survivors << "," << jarvis_time
+              << "," << jarvis_filtered_time << "," << graham_time << ","
+              << graham_filtered_time << "," << chan_time << ","
+              << chan_filtered_time << "," << monotone_time << ","
+              << monotone_filtered_time << "\n";
+
+      auto speedup = [](long plain, long filtered) {
+        return static_cast<double>(plain) / std::max(filtered, 1L);
+      };
+      std::cout << "n=" << n << " trial=" << t << " | survivors: " << survivors
+                << " (" << 100.0 * survivors / n << "%)"
+                << " | Jarvis: x" << speedup(jarvis_time, jarvis_filtered_time)
+                << " | Graham: x" << speedup(graham_time, graham_filtered_time)
+                << " | Chan: x" << speedup(chan_time, chan_filtered_time)
+                << " | Monotone: x"
+                << speedup(monotone_time, monotone_filtered_time) << std::endl;
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Chan's guess schedule for m on small-h (uniform) and large-h (circle)
+// inputs: the number of rounds and the m that finally closed the hull.
+void chan_rounds() {
+  const std::vector<size_t> sizes_random{1000, 10000, 100000, 1000000};
+  const std::vector<size_t> sizes_circular{100, 300, 700, 1000, 5000};
+  const int trials = 3;
+  const std::string csv_path = "chan_rounds.csv";
+
+  std::ofstream outfile(csv_path);
+  outfile << "distribution,n,trial,hull_size,rounds,partition_size,chan_time\n";
+
+  for (bool circular : {false, true}) {
+    const auto &sizes = circular ? sizes_circular : sizes_random;
+    const std::string distribution = circular ? "circular" : "random";
+    for (size_t n : sizes) {
+      for (int t = 0; t < trials; ++t) {
+        PointSet point_set;
+        if (circular) {
+          point_set.generate_circular_points(n);
+        } else {
+          point_set.generate_points(n);
+        }
+
+        auto start_chan = std::chrono::high_resolution_clock::now();
+        ChanConvexHull chan(point_set.get_set());
+        auto end_chan = std::chrono::high_resolution_clock::now();
+        long chan_time = std::chrono::duration_cast<std::chrono::microseconds>(
+                             end_chan - start_chan)
+                             .count();
+
+        outfile << distribution << "," << n << "," << t << "," << chan.size()
+                << "," << chan.getRounds() << "," << chan.getPartitionSize()
+                << "," << chan_time << "\n";
+        std::cout << distribution << " n=" << n << " trial=" << t
+                  << " | h: " << chan.size()
+                  << " | rounds: " << chan.getRounds()
+                  << " | m: " << chan.getPartitionSize()
+                  << " | Chan: " << chan_time << "μs" << std::endl;
+      }
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Chan with its sub-hulls built on 1..16 threads. The size of the input
+// can be passed as the second argument.
+void chan_threads(size_t n) {
+  const std::vector<size_t> thread_counts{1, 2, 4, 8, 16};
+  const int trials = 3;
+  const std::string csv_path = "chan_threads.csv";
+
+  std::ofstream outfile(csv_path);
+  outfile << "n,threads,trial,chan_time\n";
+
+  PointSet point_set;
+  point_set.generate_points(n);
+  std::cout << "hardware threads: " << ThreadPool::hardwareThreads()
+            << std::endl;
+
+  for (size_t threads : thread_counts) {
+    for (int t = 0; t < trials; ++t) {
       auto start_chan = std::chrono::high_resolution_clock::now();
-      ChanConvexHull chan(point_set.get_set());
+      ChanConvexHull chan(point_set.get_set(), Prefilter::NONE, threads);
       auto end_chan = std::chrono::high_resolution_clock::now();
       long chan_time = std::chrono::duration_cast<std::chrono::microseconds>(
                            end_chan - start_chan)
                            .count();
 
-      // Save results
-      outfile << n << "," << t << "," << jarvis_time << "," << graham_time
-              << "," << chan_time << "\n";
-      // outfile << n << "," << t << "," << 0 << "," << graham_time << ","
-      //         << chan_time << "\n";
-
-      std::cout << "n=" << n << " trial=" << t << " | Jarvis: " << jarvis_time
-                << "μs"
-                << " | Graham: " << graham_time << "μs"
+      outfile << n << "," << threads << "," << t << "," << chan_time << "\n";
+      std::cout << "n=" << n << " threads=" << threads << " trial=" << t
                 << " | Chan: " << chan_time << "μs" << std::endl;
-      // std::cout << "n=" << n << " trial=" << t << " | Jarvis: " << 0 << "μs"
-      //           << " | Graham: " << graham_time << "μs"
-      //           << " | Chan: " << chan_time << "μs" << std::endl;
     }
   }
   outfile.close();
   std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Jarvis and the pre-filter with the orientation kernel forced to scalar
+// and with the best instruction set of the machine, on the points and on
+// the SoA columns.
+void simd_comparison() {
+  const std::vector<size_t> sizes{10000, 100000, 1000000};
+  const int trials = 5;
+  const std::string csv_path = "simd.csv";
+  const simd::Isa best_isa = simd::detectIsa();
+
+  std::ofstream outfile(csv_path);
+  outfile << "n,trial,isa,jarvis_aos_time,jarvis_soa_time,filter_time\n";
+  std::cout << "best instruction set: " << simd::isaName(best_isa)
+            << std::endl;
+
+  auto elapsed = [](auto &&build) {
+    auto start = std::chrono::high_resolution_clock::now();
+    build();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+        .count();
+  };
+
+  for (size_t n : sizes) {
+    for (int t = 0; t < trials; ++t) {
+      PointSet point_set;
+      point_set.generate_points(n);
+      point_set.enable_soa();
+
+      for (simd::Isa isa : {simd::Isa::SCALAR, best_isa}) {
+        simd::setIsa(isa);
+        long jarvis_aos_time =
+            elapsed([&] { JarvisConvexHull jarvis(point_set.get_set()); });
+        long jarvis_soa_time =
+            elapsed([&] { JarvisConvexHull jarvis(point_set); });
+        long filter_time = elapsed(
+            [&] { AklToussaintFilter filter(point_set.get_set()); });
+
+        outfile << n << "," << t << "," << simd::isaName(isa) << ","
+                << jarvis_aos_time << "," << jarvis_soa_time << ","
+                << filter_time << "\n";
+        std::cout << "n=" << n << " trial=" << t << " isa=" << std::left
+                  << std::setw(6) << simd::isaName(isa) << std::right
+                  << " | Jarvis AoS: " << jarvis_aos_time << "μs"
+                  << " | Jarvis SoA: " << jarvis_soa_time << "μs"
+                  << " | Filter: " << filter_time << "μs" << std::endl;
+      }
+      simd::setIsa(best_isa);
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Share of orientation tests that needed exact arithmetic, and whether the
+// engines still agree, on easy, shifted and nearly degenerate inputs.
+// Single threaded: the predicate counters are per thread.
+void predicates_comparison() {
+  const size_t n = 100000;
+  const std::string csv_path = "predicates.csv";
+
+  std::ofstream outfile(csv_path);
+  outfile << "input,engine,time,calls,exact,hull_size,agrees\n";
+
+  // points on a random line, rounded to doubles: almost all of them are
+  // collinear up to the last bit
+  auto near_line = [](size_t size) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> t_dist(0.0, 1.0);
+    std::vector<Point> points;
+    points.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      double t = t_dist(gen);
+      points.emplace_back(0.1 + 0.3 * t, 0.2 + 0.7 * t);
+    }
+    return points;
+  };
+
+  PointSet random_set;
+  random_set.generate_points(n);
+  std::vector<Point> shifted = random_set.get_set();
+  for (auto &point : shifted) {
+    point = point + Point(1e15, 1e15);
+  }
+  PointSet circle_set;
+  circle_set.generate_circular_points(n);
+
+  const std::vector<std::pair<std::string, std::vector<Point>>> inputs{
+      {"random", random_set.get_set()},
+      {"shifted", shifted},
+      {"circle", circle_set.get_set()},
+      {"near_line", near_line(n)}};
+
+  for (const auto &[name, points] : inputs) {
+    GrahamConvexHull reference(points);
+    auto run = [&](const std::string &engine, auto &&build) {
+      predicates::resetCounters();
+      auto start = std::chrono::high_resolution_clock::now();
+      std::vector<Point> hull = build();
+      auto end = std::chrono::high_resolution_clock::now();
+      long time = std::chrono::duration_cast<std::chrono::microseconds>(
+                      end - start)
+                      .count();
+      const predicates::Counters counters = predicates::counters();
+      bool agrees = hull == reference.getHull();
+
+      outfile << name << "," << engine << "," << time << "," << counters.calls
+              << "," << counters.exact << "," << hull.size() << ","
+              << agrees << "\n";
+      std::cout << std::left << std::setw(10) << name << std::setw(9)
+                << engine << std::right << " | " << time << "μs"
+                << " | tests: " << counters.calls
+                << " | exact: " << counters.exact << " ("
+                << (counters.calls ? 100.0 * counters.exact / counters.calls
+                                   : 0.0)
+                << "%) | hull: " << hull.size()
+                << (agrees ? "" : " | DIFFERS FROM GRAHAM") << std::endl;
+    };
+    run("graham", [&] { return GrahamConvexHull(points).getHull(); });
+    run("monotone", [&] { return MonotoneChainConvexHull(points).getHull(); });
+    run("chan", [&] { return ChanConvexHull(points).getHull(); });
+    if (name != "circle") {
+      run("jarvis", [&] { return JarvisConvexHull(points).getHull(); });
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// The same integer-valued points as float, double, int32 and int64
+// coordinates, and as double with the unfiltered predicates, then
+// non-integer floats; every engine is checked against the monotone chain.
+void coordinate_types() {
+  const std::vector<size_t> sizes{100000, 1000000};
+  const int trials = 3;
+  const std::string csv_path = "types.csv";
+
+  std::ofstream outfile(csv_path);
+  outfile << "n,trial,type,graham_time,monotone_time,chan_time,jarvis_time,"
+             "hull_size,agrees\n";
+
+  auto elapsed = [](auto &&build) {
+    auto start = std::chrono::high_resolution_clock::now();
+    build();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+        .count();
+  };
+
+  for (size_t n : sizes) {
+    for (int t = 0; t < trials; ++t) {
+      std::mt19937 gen(t);
+      std::uniform_int_distribution<int32_t> dist(-1000000, 1000000);
+      std::vector<std::pair<int32_t, int32_t>> raw(n);
+      for (auto &[x, y] : raw) {
+        x = dist(gen);
+        y = dist(gen);
+      }
+
+      // non-integer floats, whose differences round in float, in a narrow
+      // strip so that many of them are nearly collinear with the pivot
+      std::uniform_real_distribution<float> fraction(-5.0f, 5.0f);
+      std::vector<BasicPoint<float>> fractional(n);
+      for (auto &point : fractional) {
+        point = BasicPoint<float>(fraction(gen) / 10, fraction(gen));
+      }
+
+      // every engine's hull is compared with the monotone chain's
+      auto run = [&](const auto &points, auto policy, const char *type) {
+        using T = typename std::decay_t<decltype(points[0])>::coordinate_type;
+        using Policy = decltype(policy);
+        std::vector<BasicPoint<T>> graham_hull, monotone_hull, chan_hull,
+            jarvis_hull;
+        long graham_time = elapsed([&] {
+          graham_hull = BasicGrahamConvexHull<T, Policy>(points).getHull();
+        });
+        long monotone_time = elapsed([&] {
+          monotone_hull =
+              BasicMonotoneChainConvexHull<T, Policy>(points).getHull();
+        });
+        long chan_time = elapsed([&] {
+          chan_hull = BasicChanConvexHull<T, Policy>(points).getHull();
+        });
+        long jarvis_time = elapsed([&] {
+          jarvis_hull = BasicJarvisConvexHull<T, Policy>(points).getHull();
+        });
+        const size_t hull_size = graham_hull.size();
+        const bool agrees = graham_hull == monotone_hull &&
+                            chan_hull == monotone_hull &&
+                            jarvis_hull == monotone_hull;
+
+        outfile << n << "," << t << "," << type << "," << graham_time << ","
+                << monotone_time << "," << chan_time << "," << jarvis_time
+                << "," << hull_size << "," << agrees << "\n";
+        std::cout << "n=" << n << " trial=" << t << " " << std::left
+                  << std::setw(11) << type << std::right
+                  << " | Graham: " << graham_time << "μs"
+                  << " | Monotone: " << monotone_time << "μs"
+                  << " | Chan: " << chan_time << "μs"
+                  << " | Jarvis: " << jarvis_time << "μs"
+                  << " | hull: " << hull_size
+                  << (agrees ? "" : " | DIFFERS FROM MONOTONE") << std::endl;
+      };
+      auto converted = [&](auto tag) {
+        using T = decltype(tag);
+        std::vector<BasicPoint<T>> points;
+        points.reserve(n);
+        for (const auto &[x, y] : raw) {
+          points.emplace_back(static_cast<T>(x), static_cast<T>(y));
+        }
+        return points;
+      };
+      run(converted(float{}), predicates::Exact<float>{}, "float");
+      run(converted(double{}), predicates::Exact<double>{}, "double");
+      run(converted(int32_t{}), predicates::Exact<int32_t>{}, "int32");
+      run(converted(int64_t{}), predicates::Exact<int64_t>{}, "int64");
+      run(converted(double{}), predicates::Fast<double>{}, "double_fast");
+      run(fractional, predicates::Exact<float>{}, "float_frac");
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// A stream of points fed one at a time: the incremental hull against
+// rebuilding the monotone chain over everything received so far. For each
+// feed rate the hull has to be current after every insert, so a method
+// keeps up while its time per insert stays under 1 / rate.
+void incremental_stream(size_t total) {
+  const std::vector<double> rates{1e5, 1e6, 1e7};
+  const std::string csv_path = "incremental.csv";
+
+  std::ofstream outfile(csv_path);
+  outfile << "distribution,n,insert_ns,insert_rate,rebuild_us,rebuild_rate\n";
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  auto uniform = [&] { return Point(unit(gen) * 1000, unit(gen) * 1000); };
+  // every point lands on the hull and hides some of the previous ones
+  auto circle = [&] {
+    double angle = unit(gen) * 2 * M_PI;
+    return Point(500 + 400 * std::cos(angle), 500 + 400 * std::sin(angle));
+  };
+
+  for (const std::string distribution : {"uniform", "circle"}) {
+    std::vector<Point> stream(total);
+    for (auto &point : stream) {
+      point = distribution == "uniform" ? uniform() : circle();
+    }
+
+    IncrementalConvexHull incremental;
+    size_t done = 0;
+    for (size_t checkpoint = 1000; checkpoint <= total; checkpoint *= 10) {
+      const size_t segment_begin = done;
+      auto start = std::chrono::high_resolution_clock::now();
+      for (; done < checkpoint; ++done) {
+        incremental.insert(stream[done]);
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+      // mean over the inserts since the previous checkpoint
+      double insert_ns =
+          std::chrono::duration<double, std::nano>(end - start).count() /
+          (checkpoint - segment_begin);
+
+      start = std::chrono::high_resolution_clock::now();
+      MonotoneChainConvexHull rebuilt(
+          std::span<const Point>(stream.data(), checkpoint));
+      end = std::chrono::high_resolution_clock::now();
+      double rebuild_us =
+          std::chrono::duration<double, std::micro>(end - start).count();
+      if (rebuilt.size() != incremental.size()) {
+        std::cout << "hull sizes differ at n=" << checkpoint << std::endl;
+      }
+
+      double insert_rate = 1e9 / insert_ns;
+      double rebuild_rate = 1e6 / rebuild_us;
+      outfile << distribution << "," << checkpoint << "," << insert_ns << ","
+              << insert_rate << "," << rebuild_us << "," << rebuild_rate
+              << "\n";
+      std::cout << std::left << std::setw(8) << distribution << std::right
+                << " n=" << checkpoint << " hull=" << incremental.size()
+                << " | insert: " << insert_ns << "ns"
+                << " | rebuild: " << rebuild_us << "μs"
+                << " | keeps up at";
+      for (double rate : rates) {
+        std::cout << " " << rate << "/s: "
+                  << (insert_rate >= rate ? "incremental" : "-") << ","
+                  << (rebuild_rate >= rate ? "rebuild" : "-");
+      }
+      std::cout << std::endl;
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// A generated feed drifting across the plane, replayed through the sliding
+// window hull, which reports the window's hull after every point, against
+// recomputing Graham over each window. Graham only runs on `sampled`
+// windows and its time per window is averaged over them.
+void sliding_window(size_t total) {
+  const std::vector<size_t> windows{1000, 10000, 100000};
+  const size_t sampled = 200;
+  const std::string csv_path = "window.csv";
+
+  std::ofstream outfile(csv_path);
+  outfile << "window,points,window_us,graham_us,speedup,mismatches\n";
+
+  std::mt19937 gen(11);
+  std::normal_distribution<double> noise(0.0, 50.0);
+  std::vector<Point> feed(total);
+  for (size_t i = 0; i < total; ++i) {
+    double drift = 1000.0 * i / total;
+    feed[i] = Point(drift + noise(gen), drift / 2 + noise(gen));
+  }
+
+  for (size_t window : windows) {
+    if (window > total) {
+      continue;
+    }
+    SlidingWindowConvexHull hull(window);
+    std::vector<size_t> hull_sizes(total);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < total; ++i) {
+      hull.push(feed[i]);
+      hull_sizes[i] = hull.size();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double window_us =
+        std::chrono::duration<double, std::micro>(end - start).count() / total;
+
+    // full windows only, evenly spread over the feed
+    double graham_total = 0;
+    size_t mismatches = 0;
+    const size_t samples = std::min(sampled, total - window + 1);
+    for (size_t s = 0; s < samples; ++s) {
+      size_t last = window - 1 + (total - window) * s / samples;
+      std::span<const Point> points(feed.data() + last + 1 - window, window);
+      start = std::chrono::high_resolution_clock::now();
+      GrahamConvexHull graham(points);
+      end = std::chrono::high_resolution_clock::now();
+      graham_total +=
+          std::chrono::duration<double, std::micro>(end - start).count();
+      if (graham.size() != hull_sizes[last]) {
+        ++mismatches;
+      }
+    }
+    double graham_us = graham_total / samples;
+
+    outfile << window << "," << total << "," << window_us << "," << graham_us
+            << "," << graham_us / window_us << "," << mismatches << "\n";
+    std::cout << "window=" << window << " points=" << total
+              << " | sliding: " << window_us << "μs/point"
+              << " | Graham per window: " << graham_us << "μs"
+              << " | speedup: " << graham_us / window_us << "x"
+              << (mismatches ? " | HULLS DIFFER" : "") << std::endl;
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Peak resident memory of the process so far, in MiB (VmHWM).
+double peak_memory_mib() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind("VmHWM:", 0) == 0) {
+      return std::stod(line.substr(6)) / 1024;
+    }
+  }
+  return 0;
+}
+
+// Writes n random points to a binary file in blocks, never holding them
+// all, then finds their hull out of core with growing chunk sizes. The
+// peak memory stays near the chunk size however large the file is.
+void out_of_core(size_t n, const std::string &path) {
+  const std::vector<size_t> chunk_sizes{size_t{1} << 16, size_t{1} << 20,
+                                        size_t{1} << 22};
+  const std::string csv_path = "outofcore.csv";
+
+  {
+    std::ofstream file(path, std::ios::binary);
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> coordinate(0.0, 1e6);
+    std::vector<Point> block;
+    for (size_t written = 0; written < n; written += block.size()) {
+      block.resize(std::min<size_t>(1 << 16, n - written));
+      for (auto &point : block) {
+        point = Point(coordinate(gen), coordinate(gen));
+      }
+      file.write(reinterpret_cast<const char *>(block.data()),
+                 block.size() * sizeof(Point));
+    }
+    if (!file) {
+      throw std::runtime_error("Can't write " + path);
+    }
+  }
+  std::cout << "wrote " << n << " points ("
+            << n * sizeof(Point) / (1024.0 * 1024.0) << " MiB) to " << path
+            << ", peak memory " << peak_memory_mib() << " MiB" << std::endl;
+
+  std::ofstream outfile(csv_path);
+  outfile << "n,chunk_size,time_ms,points_per_s,hull_size,peak_mib\n";
+  for (size_t chunk_size : chunk_sizes) {
+    MappedPointFile file(path);
+    OutOfCoreConvexHull hull(chunk_size);
+    auto start = std::chrono::high_resolution_clock::now();
+    hull.add(file);
+    auto end = std::chrono::high_resolution_clock::now();
+    double time_ms =
+        std::chrono::duration<double, std::milli>(end - start).count();
+    double rate = n / (time_ms / 1000);
+    double peak = peak_memory_mib();
+
+    outfile << n << "," << chunk_size << "," << time_ms << "," << rate << ","
+            << hull.size() << "," << peak << "\n";
+    std::cout << "chunk=" << chunk_size << " | " << time_ms << "ms"
+              << " | " << rate << " points/s"
+              << " | hull: " << hull.size()
+              << " | peak memory: " << peak << " MiB" << std::endl;
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// The same n points as CSV and as a columnar point file: CSV ingest with
+// 1, 2, 4 and 8 threads against mapping the point file, both checked to
+// give back the points that were written.
+void file_io(size_t n) {
+  const std::string csv_points = "points.csv";
+  const std::string bin_points = "points.bin";
+  const std::string csv_path = "io.csv";
+
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<double> coordinate(0.0, 1e6);
+  std::vector<Point> points;
+  points.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    points.emplace_back(coordinate(gen), coordinate(gen));
+  }
+  csv::write<double>(csv_points, points);
+  writePointFile<double>(bin_points, points);
+
+  std::ofstream outfile(csv_path);
+  outfile << "n,format,threads,time_ms,points_per_s,matches\n";
+  auto report = [&](const std::string &format, size_t threads, double time_ms,
+                    bool matches) {
+    double rate = n / (time_ms / 1000);
+    outfile << n << "," << format << "," << threads << "," << time_ms << ","
+            << rate << "," << matches << "\n";
+    std::cout << std::left << std::setw(7) << format << std::right
+              << " threads=" << threads << " | " << time_ms << "ms | " << rate
+              << " points/s" << (matches ? "" : " | MISMATCH") << std::endl;
+  };
+
+  for (size_t threads : {1, 2, 4, 8}) {
+    ThreadPool pool(threads);
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<Point> read = csv::read(csv_points, pool);
+    auto end = std::chrono::high_resolution_clock::now();
+    report("csv", threads,
+           std::chrono::duration<double, std::milli>(end - start).count(),
+           read == points);
+  }
+
+  // mapping itself reads nothing, so the time includes one pass over both
+  // columns: their maxima, checked against the header
+  auto start = std::chrono::high_resolution_clock::now();
+  PointFile file(bin_points);
+  std::span<const double> xs = file.xs<double>();
+  std::span<const double> ys = file.ys<double>();
+  double max_x = *std::max_element(xs.begin(), xs.end());
+  double max_y = *std::max_element(ys.begin(), ys.end());
+  auto end = std::chrono::high_resolution_clock::now();
+  bool matches = file.size() == n && max_x == file.header().max_x &&
+                 max_y == file.header().max_y;
+  for (size_t i = 0; matches && i < n; ++i) {
+    matches = xs[i] == points[i].x_ && ys[i] == points[i].y_;
+  }
+  report("binary", 1,
+         std::chrono::duration<double, std::milli>(end - start).count(),
+         matches);
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// The engines on points recorded in a file (CSV or point file).
+void recorded_points(const std::string &path) {
+  auto start = std::chrono::high_resolution_clock::now();
+  PointSet point_set;
+  point_set.load(path);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::cout << "loaded " << point_set.size() << " points from " << path
+            << " in "
+            << std::chrono::duration<double, std::milli>(end - start).count()
+            << "ms" << std::endl;
+
+  const std::vector<Point> &points = point_set.get_set();
+  auto run = [&](const std::string &engine, auto &&build) {
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t hull_size = build();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << std::left << std::setw(9) << engine << std::right << " | "
+              << std::chrono::duration_cast<std::chrono::microseconds>(
+                     end - start)
+                     .count()
+              << "μs | hull: " << hull_size << std::endl;
+  };
+  run("graham", [&] { return GrahamConvexHull(points).size(); });
+  run("monotone", [&] { return MonotoneChainConvexHull(points).size(); });
+  run("chan", [&] { return ChanConvexHull(points).size(); });
+  run("dc", [&] { return DivideConquerConvexHull(points).size(); });
+  run("quickhull", [&] { return QuickHullConvexHull(points).size(); });
+  run("jarvis", [&] { return JarvisConvexHull(points).size(); });
+}
+
+// Divide and conquer and QuickHull on 1..16 threads against the
+// sequential monotone chain and Chan on all threads, on uniform points and
+// on points of a circle (every point on the hull). The size of the input
+// can be passed as the second argument.
+void divide_conquer(size_t n) {
+  const std::vector<size_t> thread_counts{1, 2, 4, 8, 16};
+  const std::string csv_path = "divide_conquer.csv";
+
+  std::ofstream outfile(csv_path);
+  outfile << "input,n,engine,threads,time_ms,hull_size,agrees\n";
+  std::cout << "hardware threads: " << ForkJoinPool::hardwareThreads()
+            << std::endl;
+
+  PointSet random_set;
+  random_set.generate_points(n);
+  PointSet circle_set;
+  circle_set.generate_circular_points(n / 10);
+  const std::vector<std::pair<std::string, const PointSet *>> inputs{
+      {"random", &random_set}, {"circle", &circle_set}};
+
+  for (const auto &[name, point_set] : inputs) {
+    const std::vector<Point> &points = point_set->get_set();
+    std::vector<Point> reference;
+    auto run = [&](const std::string &engine, size_t threads, auto &&build) {
+      auto start = std::chrono::high_resolution_clock::now();
+      std::vector<Point> hull = build();
+      auto end = std::chrono::high_resolution_clock::now();
+      double time_ms =
+          std::chrono::duration<double, std::milli>(end - start).count();
+      if (reference.empty()) {
+        reference = hull;
+      }
+      bool agrees = hull == reference;
+
+      outfile << name << "," << points.size() << "," << engine << ","
+              << threads << "," << time_ms << "," << hull.size() << ","
+              << agrees << "\n";
+      std::cout << std::left << std::setw(7) << name << std::setw(10) << engine
+                << std::right << " threads=" << std::setw(2) << threads
+                << " | " << time_ms << "ms | hull: " << hull.size()
+                << (agrees ? "" : " | DIFFERS FROM MONOTONE") << std::endl;
+    };
+    run("monotone", 1,
+        [&] { return MonotoneChainConvexHull(points).getHull(); });
+    run("chan", ThreadPool::hardwareThreads(), [&] {
+      return ChanConvexHull(points, Prefilter::NONE, 0).getHull();
+    });
+    for (size_t threads : thread_counts) {
+      run("dc", threads, [&] {
+        return DivideConquerConvexHull(points, Prefilter::NONE, threads)
+            .getHull();
+      });
+      run("quickhull", threads, [&] {
+        return QuickHullConvexHull(points, Prefilter::NONE, threads).getHull();
+      });
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Hulls of many small gaussian clusters (10 to 500 points each) in one CSR
+// buffer: an engine built per cluster against the batch API on 1, 2, 4 and
+// 8 threads, in hulls per second. The number of clusters can be passed as
+// the second argument.
+void batch_hulls(size_t clusters) {
+  const std::string csv_path = "batch.csv";
+  const int trials = 3;
+
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<size_t> size_dist(10, 500);
+  std::uniform_real_distribution<double> centre(0.0, 1e4);
+  std::normal_distribution<double> spread(0.0, 20.0);
+  std::vector<Point> points;
+  std::vector<size_t> offsets{0};
+  for (size_t c = 0; c < clusters; ++c) {
+    const Point at(centre(gen), centre(gen));
+    for (size_t i = size_dist(gen); i > 0; --i) {
+      points.push_back(at + Point(spread(gen), spread(gen)));
+    }
+    offsets.push_back(points.size());
+  }
+  std::cout << clusters << " clusters, " << points.size() << " points"
+            << std::endl;
+
+  std::ofstream outfile(csv_path);
+  outfile << "clusters,engine,threads,trial,time_ms,hulls_per_s,agrees\n";
+  std::vector<size_t> reference;
+  auto run = [&](const std::string &engine, size_t threads, auto &&build) {
+    for (int t = 0; t < trials; ++t) {
+      auto start = std::chrono::high_resolution_clock::now();
+      std::vector<size_t> sizes = build();
+      auto end = std::chrono::high_resolution_clock::now();
+      double time_ms =
+          std::chrono::duration<double, std::milli>(end - start).count();
+      if (reference.empty()) {
+        reference = sizes;
+      }
+      bool agrees = sizes == reference;
+      double rate = clusters / (time_ms / 1000);
+
+      outfile << clusters << "," << engine << "," << threads << "," << t
+              << "," << time_ms << "," << rate << "," << agrees << "\n";
+      std::cout << std::left << std::setw(9) << engine << std::right
+                << " threads=" << threads << " trial=" << t << " | "
+                << time_ms << "ms | " << rate << " hulls/s"
+                << (agrees ? "" : " | DIFFERS") << std::endl;
+    }
+  };
+  auto per_cluster = [&]<typename Engine>() {
+    std::vector<size_t> sizes;
+    for (size_t c = 0; c < clusters; ++c) {
+      Engine hull(std::span<const Point>(points).subspan(
+          offsets[c], offsets[c + 1] - offsets[c]));
+      sizes.push_back(hull.size());
+    }
+    return sizes;
+  };
+  run("graham", 1, [&] { return per_cluster.operator()<GrahamConvexHull>(); });
+  run("monotone", 1,
+      [&] { return per_cluster.operator()<MonotoneChainConvexHull>(); });
+  for (size_t threads : {1, 2, 4, 8}) {
+    run("batch", threads, [&] {
+      BatchConvexHull batch(points, offsets, threads);
+      std::vector<size_t> sizes;
+      for (size_t c = 0; c < batch.batchSize(); ++c) {
+        sizes.push_back(batch.getHull(c).size());
+      }
+      return sizes;
+    });
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Chan with its partitions cut by input order, by x and along the Morton
+// curve, on uniform points, on gaussian clusters and on a circle: time,
+// the sub-hulls of the last round and how many of them were culled, and
+// the orientation tests. The size of the input can be passed as the
+// second argument.
+void chan_partitioning(size_t n) {
+  const std::string csv_path = "chan_partitioning.csv";
+
+  PointSet random_set;
+  random_set.generate_points(n);
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> centre(0.0, 1e4);
+  std::normal_distribution<double> spread(0.0, 50.0);
+  std::vector<Point> clustered;
+  clustered.reserve(n);
+  for (size_t c = 0; c < 100; ++c) {
+    const Point at(centre(gen), centre(gen));
+    for (size_t i = c * n / 100; i < (c + 1) * n / 100; ++i) {
+      clustered.push_back(at + Point(spread(gen), spread(gen)));
+    }
+  }
+  PointSet circle_set;
+  circle_set.generate_circular_points(n / 100);
+  const std::vector<std::pair<std::string, const std::vector<Point> *>> inputs{
+      {"random", &random_set.get_set()},
+      {"clustered", &clustered},
+      {"circle", &circle_set.get_set()}};
+  const std::vector<std::pair<std::string, ChanPartitioning>> partitionings{
+      {"index", ChanPartitioning::INDEX},
+      {"x_slabs", ChanPartitioning::X_SLABS},
+      {"morton", ChanPartitioning::MORTON}};
+
+  std::ofstream outfile(csv_path);
+  outfile << "input,n,partitioning,time_ms,rounds,partitions,culled,tests,"
+             "agrees\n";
+  for (const auto &[name, points] : inputs) {
+    GrahamConvexHull reference(*points);
+    for (const auto &[partitioning_name, partitioning] : partitionings) {
+      predicates::resetCounters();
+      auto start = std::chrono::high_resolution_clock::now();
+      ChanConvexHull chan(*points, Prefilter::NONE, 1, partitioning);
+      auto end = std::chrono::high_resolution_clock::now();
+      const size_t tests = predicates::counters().calls;
+      double time_ms =
+          std::chrono::duration<double, std::milli>(end - start).count();
+      const size_t partitions =
+          chan.getPartitionsNumber() + chan.getCulledNumber();
+      bool agrees = chan.getHull() == reference.getHull();
+
+      outfile << name << "," << points->size() << "," << partitioning_name
+              << "," << time_ms << "," << chan.getRounds() << ","
+              << partitions << "," << chan.getCulledNumber() << "," << tests
+              << "," << agrees << "\n";
+      std::cout << std::left << std::setw(10) << name << std::setw(8)
+                << partitioning_name << std::right << " | " << time_ms << "ms"
+                << " | rounds: " << chan.getRounds()
+                << " | sub-hulls: " << partitions
+                << " | culled: " << chan.getCulledNumber()
+                << " | tests: " << tests
+                << (agrees ? "" : " | DIFFERS FROM GRAHAM") << std::endl;
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Chan's wrap with the tangents found by binary search and by walking on
+// from the previous step's tangent, on random points, a disk (h ~ n^1/3)
+// and points of a circle (h = n): time and orientation tests per wrapping
+// step over all the rounds. The size of the input can be passed as the
+// second argument.
+void chan_tangents(size_t n) {
+  const std::string csv_path = "chan_tangents.csv";
+
+  PointSet random_set;
+  random_set.generate_points(n);
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::vector<Point> disk;
+  disk.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    const double radius = std::sqrt(unit(gen)) * 400;
+    const double angle = unit(gen) * 2 * M_PI;
+    disk.emplace_back(500 + radius * std::cos(angle),
+                      500 + radius * std::sin(angle));
+  }
+  PointSet circle_set;
+  circle_set.generate_circular_points(n / 10);
+  const std::vector<std::pair<std::string, const std::vector<Point> *>> inputs{
+      {"random", &random_set.get_set()},
+      {"disk", &disk},
+      {"circle", &circle_set.get_set()}};
+  const std::vector<std::pair<std::string, ChanTangentSearch>> searches{
+      {"binary", ChanTangentSearch::BINARY},
+      {"finger", ChanTangentSearch::FINGER}};
+
+  std::ofstream outfile(csv_path);
+  outfile << "input,n,search,time_ms,hull_size,steps,tests,tests_per_step,"
+             "median_step_tests\n";
+  for (const auto &[name, points] : inputs) {
+    for (const auto &[search_name, search] : searches) {
+      auto start = std::chrono::high_resolution_clock::now();
+      ChanConvexHull chan(*points, Prefilter::NONE, 1, ChanPartitioning::INDEX,
+                          search);
+      auto end = std::chrono::high_resolution_clock::now();
+      double time_ms =
+          std::chrono::duration<double, std::milli>(end - start).count();
+      const std::vector<size_t> &step_tests = chan.getStepTests();
+      size_t tests = 0;
+      for (size_t step : step_tests) {
+        tests += step;
+      }
+      // the first step of a round searches every sub-hull from scratch
+      std::vector<size_t> sorted = step_tests;
+      std::sort(sorted.begin(), sorted.end());
+      const size_t median = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+      const double per_step =
+          step_tests.empty() ? 0.0 : double(tests) / step_tests.size();
+
+      outfile << name << "," << points->size() << "," << search_name << ","
+              << time_ms << "," << chan.size() << "," << step_tests.size()
+              << "," << tests << "," << per_step << "," << median << "\n";
+      std::cout << std::left << std::setw(7) << name << std::setw(7)
+                << search_name << std::right << " | " << time_ms << "ms"
+                << " | h: " << chan.size()
+                << " | steps: " << step_tests.size()
+                << " | tests/step: " << per_step << " (median " << median
+                << ")" << std::endl;
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Queries against hulls of 16 to 1e6 vertices (points of a circle): point
+// location, extreme vertex, tangents and line crossings with the
+// ConvexPolygonIndex against a linear scan of the hull, and the batched
+// location, in nanoseconds per query. The linear scans run on fewer
+// queries for the large hulls. The number of queries can be passed as the
+// second argument.
+void hull_queries(size_t queries) {
+  const std::vector<size_t> hull_sizes{16, 1024, 65536, 1000000};
+  const std::string csv_path = "hull_queries.csv";
+
+  std::mt19937 gen(13);
+  std::uniform_real_distribution<double> coordinate(-1.5, 1.5);
+  std::vector<Point> points(queries);
+  for (auto &point : points) {
+    point = Point(coordinate(gen), coordinate(gen));
+  }
+
+  std::ofstream outfile(csv_path);
+  outfile << "hull_size,query,method,queries,ns_per_query,agrees\n";
+  for (size_t h : hull_sizes) {
+    PointSet circle_set;
+    circle_set.generate_circular_points(h);
+    MonotoneChainConvexHull engine(circle_set.get_set());
+    const std::vector<Point> &hull = engine.getHull();
+    ConvexPolygonIndex index(hull);
+    // a linear scan of every query would take hours on the largest hulls
+    const size_t scanned =
+        std::min(queries, std::max<size_t>(1000, 100000000 / h));
+
+    // the time per query of answer(count), and its answers
+    auto run = [&](size_t count, auto &&answer) {
+      auto start = std::chrono::high_resolution_clock::now();
+      auto answers = answer(count);
+      auto end = std::chrono::high_resolution_clock::now();
+      const double ns =
+          std::chrono::duration<double, std::nano>(end - start).count() /
+          count;
+      return std::make_pair(ns, answers);
+    };
+    auto report = [&](const std::string &query, const std::string &method,
+                      size_t count, double ns, bool agrees) {
+      outfile << h << "," << query << "," << method << "," << count << ","
+              << ns << "," << agrees << "\n";
+      std::cout << "h=" << std::left << std::setw(8) << h << std::setw(9)
+                << query << std::setw(8) << method << std::right << " | "
+                << ns << " ns/query"
+                << (agrees ? "" : " | DIFFERS FROM LINEAR SCAN") << std::endl;
+    };
+
+    // point location: left of every edge, or not
+    auto [scan_ns, scan_inside] = run(scanned, [&](size_t count) {
+      std::vector<size_t> inside(count);
+      for (size_t i = 0; i < count; ++i) {
+        bool in = true;
+        for (size_t e = 0; e < hull.size() && in; ++e) {
+          in = predicates::orientation(hull[e], hull[(e + 1) % hull.size()],
+                                       points[i]) >= 0;
+        }
+        inside[i] = in;
+      }
+      return inside;
+    });
+    report("contains", "linear", scanned, scan_ns, true);
+    auto [index_ns, index_inside] = run(queries, [&](size_t count) {
+      std::vector<size_t> inside(count);
+      for (size_t i = 0; i < count; ++i) {
+        inside[i] = index.contains(points[i]);
+      }
+      return inside;
+    });
+    report("contains", "index", queries, index_ns,
+           std::equal(scan_inside.begin(), scan_inside.end(),
+                      index_inside.begin()));
+    auto [batch_ns, batch_inside] = run(queries, [&](size_t count) {
+      std::vector<HullLocation> locations(count);
+      index.locate(std::span<const Point>(points).first(count), locations);
+      std::vector<size_t> inside(count);
+      for (size_t i = 0; i < count; ++i) {
+        inside[i] = locations[i] != HullLocation::OUTSIDE;
+      }
+      return inside;
+    });
+    report("contains", "batch", queries, batch_ns,
+           batch_inside == index_inside);
+
+    // extreme vertex in the direction of the query point
+    auto [scan_extreme_ns, scan_extreme] = run(scanned, [&](size_t count) {
+      std::vector<size_t> extreme(count);
+      for (size_t i = 0; i < count; ++i) {
+        const Point &d = points[i];
+        double best = hull[0].x_ * d.x_ + hull[0].y_ * d.y_;
+        for (size_t v = 1; v < hull.size(); ++v) {
+          const double dot = hull[v].x_ * d.x_ + hull[v].y_ * d.y_;
+          if (dot > best) {
+            best = dot;
+            extreme[i] = v;
+          }
+        }
+      }
+      return extreme;
+    });
+    report("extreme", "linear", scanned, scan_extreme_ns, true);
+    auto [index_extreme_ns, index_extreme] = run(queries, [&](size_t count) {
+      std::vector<size_t> extreme(count);
+      for (size_t i = 0; i < count; ++i) {
+        extreme[i] = index.extremeVertex(points[i]);
+      }
+      return extreme;
+    });
+    // the scan keeps the first of equal dot products, the index the first
+    // counter-clockwise, so compare the dot products
+    bool same_extreme = true;
+    for (size_t i = 0; i < scanned; ++i) {
+      const Point &d = points[i];
+      const Point &p = hull[scan_extreme[i]];
+      const Point &q = hull[index_extreme[i]];
+      same_extreme = same_extreme &&
+                     p.x_ * d.x_ + p.y_ * d.y_ == q.x_ * d.x_ + q.y_ * d.y_;
+    }
+    report("extreme", "index", queries, index_extreme_ns, same_extreme);
+
+    // tangents from the query points outside the hull
+    std::vector<Point> outside;
+    for (size_t i = 0; i < queries; ++i) {
+      if (!index_inside[i]) {
+        outside.push_back(points[i]);
+      }
+    }
+    auto [scan_tangent_ns, scan_tangents] =
+        run(std::min(scanned, outside.size()), [&](size_t count) {
+          std::vector<size_t> right(count);
+          for (size_t i = 0; i < count; ++i) {
+            for (size_t v = 1; v < hull.size(); ++v) {
+              if (predicates::orientation(outside[i], hull[right[i]],
+                                          hull[v]) < 0) {
+                right[i] = v;
+              }
+            }
+          }
+          return right;
+        });
+    report("tangents", "linear", std::min(scanned, outside.size()),
+           scan_tangent_ns, true);
+    auto [index_tangent_ns, index_tangents] =
+        run(outside.size(), [&](size_t count) {
+          std::vector<size_t> right(count);
+          for (size_t i = 0; i < count; ++i) {
+            right[i] = index.tangents(outside[i])->right;
+          }
+          return right;
+        });
+    report("tangents", "index", outside.size(), index_tangent_ns,
+           std::equal(scan_tangents.begin(), scan_tangents.end(),
+                      index_tangents.begin()));
+
+    // the line through consecutive query points, clipped against the
+    // inner side of every edge
+    using Interval = std::optional<std::pair<double, double>>;
+    const size_t line_scanned = std::min(scanned, queries - 1);
+    auto [scan_line_ns, scan_lines] = run(line_scanned, [&](size_t count) {
+      std::vector<Interval> intervals(count);
+      for (size_t i = 0; i < count; ++i) {
+        const Point &a = points[i];
+        const double dx = points[i + 1].x_ - a.x_;
+        const double dy = points[i + 1].y_ - a.y_;
+        double first = -std::numeric_limits<double>::infinity();
+        double second = std::numeric_limits<double>::infinity();
+        for (size_t e = 0; e < hull.size() && first <= second; ++e) {
+          const Point &p = hull[e];
+          const Point &q = hull[(e + 1) % hull.size()];
+          // a + t (b - a) is inside for offset + t * slope >= 0
+          const double offset =
+              (q.x_ - p.x_) * (a.y_ - p.y_) - (q.y_ - p.y_) * (a.x_ - p.x_);
+          const double slope = (q.x_ - p.x_) * dy - (q.y_ - p.y_) * dx;
+          if (slope > 0) {
+            first = std::max(first, -offset / slope);
+          } else if (slope < 0) {
+            second = std::min(second, -offset / slope);
+          } else if (offset < 0) {
+            second = -std::numeric_limits<double>::infinity();
+          }
+        }
+        if (first <= second) {
+          intervals[i] = std::make_pair(first, second);
+        }
+      }
+      return intervals;
+    });
+    report("line", "linear", line_scanned, scan_line_ns, true);
+    auto [line_ns, lines] = run(queries - 1, [&](size_t count) {
+      std::vector<Interval> intervals(count);
+      for (size_t i = 0; i < count; ++i) {
+        intervals[i] = index.intersectLine(points[i], points[i + 1]);
+      }
+      return intervals;
+    });
+    // the ends are computed in double in different ways, so they agree up
+    // to rounding
+    auto near = [](double s, double t) {
+      return std::abs(s - t) <= 1e-9 * std::max(1.0, std::abs(s));
+    };
+    bool same_lines = true;
+    for (size_t i = 0; i < line_scanned; ++i) {
+      const Interval &s = scan_lines[i];
+      const Interval &t = lines[i];
+      same_lines = same_lines && s.has_value() == t.has_value() &&
+                   (!s || (near(s->first, t->first) &&
+                           near(s->second, t->second)));
+    }
+    report("line", "index", queries - 1, line_ns, same_lines);
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Diameter, width and minimum area and perimeter rectangles of hulls of 16
+// to 1e6 vertices (points of a circle) by rotating calipers, against brute
+// force over every pair of vertices and every edge up to 1e4 vertices.
+void hull_calipers() {
+  const std::vector<size_t> hull_sizes{16, 1024, 10000, 100000, 1000000};
+  // the brute force is quadratic in the hull size
+  const size_t brute_force_limit = 10000;
+  const std::string csv_path = "calipers.csv";
+
+  std::ofstream outfile(csv_path);
+  outfile << "hull_size,method,time_ms,diameter,width,min_area,"
+             "min_perimeter\n";
+  for (size_t n : hull_sizes) {
+    PointSet circle_set;
+    circle_set.generate_circular_points(n);
+    MonotoneChainConvexHull engine(circle_set.get_set());
+    const std::vector<Point> &hull = engine.getHull();
+    const size_t h = hull.size();
+
+    auto report = [&](const std::string &method, double ms, double diameter,
+                      double width, double area, double perimeter) {
+      outfile << h << "," << method << "," << ms << "," << std::setprecision(17)
+              << diameter << "," << width << "," << area << "," << perimeter
+              << std::setprecision(6) << "\n";
+      std::cout << "h=" << std::left << std::setw(8) << h << std::setw(8)
+                << method << std::right << " | " << ms << " ms | diameter "
+                << diameter << ", width " << width << ", area " << area
+                << ", perimeter " << perimeter << std::endl;
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+    RotatingCalipers calipers(hull);
+    auto end = std::chrono::high_resolution_clock::now();
+    report("calipers",
+           std::chrono::duration<double, std::milli>(end - start).count(),
+           calipers.getDiameter().length, calipers.getWidth().width,
+           calipers.getMinAreaRectangle().area,
+           calipers.getMinPerimeterRectangle().perimeter);
+
+    if (h > brute_force_limit) {
+      continue;
+    }
+    // every pair for the diameter, every edge against every vertex for the
+    // width and the rectangles
+    start = std::chrono::high_resolution_clock::now();
+    double diameter = 0;
+    for (size_t i = 0; i < h; ++i) {
+      for (size_t j = i + 1; j < h; ++j) {
+        diameter = std::max(diameter, std::hypot(hull[j].x_ - hull[i].x_,
+                                                 hull[j].y_ - hull[i].y_));
+      }
+    }
+    double width = INFINITY, area = INFINITY, perimeter = INFINITY;
+    for (size_t i = 0; i < h; ++i) {
+      const Point &a = hull[i];
+      const Point &b = hull[(i + 1) % h];
+      const double length = std::hypot(b.x_ - a.x_, b.y_ - a.y_);
+      const double ux = (b.x_ - a.x_) / length, uy = (b.y_ - a.y_) / length;
+      double back = 0, front = 0, height = 0;
+      for (const Point &p : hull) {
+        const double along = (p.x_ - a.x_) * ux + (p.y_ - a.y_) * uy;
+        const double up = (p.y_ - a.y_) * ux - (p.x_ - a.x_) * uy;
+        back = std::min(back, along);
+        front = std::max(front, along);
+        height = std::max(height, up);
+      }
+      width = std::min(width, height);
+      area = std::min(area, (front - back) * height);
+      perimeter = std::min(perimeter, 2 * (front - back + height));
+    }
+    end = std::chrono::high_resolution_clock::now();
+    report("brute",
+           std::chrono::duration<double, std::milli>(end - start).count(),
+           diameter, width, area, perimeter);
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// The approximate hull (strip bucketing) for epsilon of 1e-2, 1e-3 and
+// 1e-4 against Graham scan, on random points, a disk and points of a
+// circle: speedup, hull sizes, the guaranteed error bound and the measured
+// error, the largest distance of an exact hull vertex from the approximate
+// hull. The size of the input can be passed as the second argument.
+void approximate_hulls(size_t n) {
+  const std::vector<double> epsilons{1e-2, 1e-3, 1e-4};
+  const std::string csv_path = "approximate.csv";
+
+  PointSet random_set;
+  random_set.generate_points(n);
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::vector<Point> disk;
+  disk.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    const double radius = std::sqrt(unit(gen)) * 400;
+    const double angle = unit(gen) * 2 * M_PI;
+    disk.emplace_back(500 + radius * std::cos(angle),
+                      500 + radius * std::sin(angle));
+  }
+  PointSet circle_set;
+  circle_set.generate_circular_points(n / 10);
+  const std::vector<std::pair<std::string, const std::vector<Point> *>> inputs{
+      {"random", &random_set.get_set()},
+      {"disk", &disk},
+      {"circle", &circle_set.get_set()}};
+
+  auto segment_distance = [](const Point &p, const Point &a, const Point &b) {
+    const double dx = b.x_ - a.x_, dy = b.y_ - a.y_;
+    const double t = std::clamp(
+        ((p.x_ - a.x_) * dx + (p.y_ - a.y_) * dy) / (dx * dx + dy * dy), 0.0,
+        1.0);
+    return std::hypot(p.x_ - a.x_ - t * dx, p.y_ - a.y_ - t * dy);
+  };
+
+  std::ofstream outfile(csv_path);
+  outfile << "input,n,epsilon,graham_ms,approx_ms,speedup,hull_size,"
+             "approx_hull_size,error_bound,error\n";
+  for (const auto &[name, points] : inputs) {
+    auto start = std::chrono::high_resolution_clock::now();
+    GrahamConvexHull graham(*points);
+    auto end = std::chrono::high_resolution_clock::now();
+    const double graham_ms =
+        std::chrono::duration<double, std::milli>(end - start).count();
+
+    for (double epsilon : epsilons) {
+      start = std::chrono::high_resolution_clock::now();
+      ApproximateConvexHull approx(*points, epsilon);
+      end = std::chrono::high_resolution_clock::now();
+      const double approx_ms =
+          std::chrono::duration<double, std::milli>(end - start).count();
+
+      // an exact hull vertex outside sees the approximate hull's edges
+      // from its left tangent to its right one
+      const std::vector<Point> &hull = approx.getHull();
+      ConvexPolygonIndex index(hull);
+      double error = 0;
+      for (const Point &vertex : graham.getHull()) {
+        const auto tangents = index.tangents(vertex);
+        if (!tangents) {
+          continue;
+        }
+        double distance = INFINITY;
+        for (size_t e = tangents->left; e != tangents->right;
+             e = (e + 1) % hull.size()) {
+          distance = std::min(distance, segment_distance(
+                                            vertex, hull[e],
+                                            hull[(e + 1) % hull.size()]));
+        }
+        error = std::max(error, distance);
+      }
+
+      outfile << name << "," << points->size() << "," << epsilon << ","
+              << graham_ms << "," << approx_ms << ","
+              << graham_ms / approx_ms << "," << graham.size() << ","
+              << approx.size() << "," << approx.getErrorBound() << ","
+              << error << "\n";
+      std::cout << std::left << std::setw(7) << name << "eps=" << std::setw(7)
+                << epsilon << std::right << " | " << approx_ms << "ms vs "
+                << graham_ms << "ms (x" << graham_ms / approx_ms << ")"
+                << " | h: " << approx.size() << " of " << graham.size()
+                << " | error: " << error << " <= " << approx.getErrorBound()
+                << std::endl;
+    }
+  }
+  outfile.close();
+  std::cout << "Results saved to " << csv_path << std::endl;
+}
+
+// Chan (its sub-hulls on every hardware thread) and Graham scan on random
+// points, traced as a timeline of their phases and counters and written as
+// Chrome trace JSON for chrome://tracing or ui.perfetto.dev. Needs a build
+// with -DHULL_TRACE (make stats-trace). The size of the input and the path
+// can be passed as the second and third arguments.
+void trace_run(size_t n, const std::string &path) {
+#ifndef HULL_TRACE
+  (void)n;
+  std::cout << "Tracing is compiled out, build with -DHULL_TRACE to write "
+            << path << std::endl;
+#else
+  PointSet point_set;
+  point_set.generate_points(n);
+  trace::clear();
+  {
+    TRACE_SCOPE("chan");
+    ChanConvexHull chan(point_set.get_set(), Prefilter::NONE,
+                        ThreadPool::hardwareThreads());
+    std::cout << "Chan: h = " << chan.size() << std::endl;
+  }
+  {
+    TRACE_SCOPE("graham");
+    GrahamConvexHull graham(point_set.get_set());
+    std::cout << "Graham: h = " << graham.size() << std::endl;
+  }
+  std::ofstream outfile(path);
+  trace::writeChromeJson(outfile);
+  outfile.close();
+  std::cout << "Trace saved to " << path << std::endl;
+#endif
+}
+
+// The benchmark harness, what `./stats` runs without a mode: every chosen
+// engine on every chosen distribution and size, with warm-up runs and
+// timed runs in nanoseconds, pinned to one CPU, summarized by median and
+// 95th/99th percentiles and written to a JSON file that plot_results.py
+// reads. One more run per engine is profiled for the hardware counters,
+// in total and per phase for Chan and Graham. Options (all optional):
+//   --engines jarvis,graham,...  --dist uniform,hull:0.1,...
+//   --sizes 1000,1e5,...  --warmup 2  --runs 10  --seed 1
+//   --cpu <k>|none  --counters on|off  --out results.json
+// The other modes time single runs themselves and write CSV.
+int benchmark(int argc, char *argv[]) {
+  using EngineRun = std::function<size_t(const std::vector<Point> &)>;
+  // the parallel engines use every hardware thread
+  const std::vector<std::pair<std::string, EngineRun>> engines{
+      {"jarvis", [](const auto &p) { return JarvisConvexHull(p).size(); }},
+      {"graham", [](const auto &p) { return GrahamConvexHull(p).size(); }},
+      {"chan", [](const auto &p) { return ChanConvexHull(p).size(); }},
+      {"monotone",
+       [](const auto &p) { return MonotoneChainConvexHull(p).size(); }},
+      {"quickhull",
+       [](const auto &p) { return QuickHullConvexHull(p).size(); }},
+      {"dc",
+       [](const auto &p) { return DivideConquerConvexHull(p).size(); }},
+      {"incremental",
+       [](const auto &p) { return IncrementalConvexHull(p).size(); }}};
+  // the run of the engine called name, null if there is none
+  auto find_engine = [&](const std::string &name) -> const EngineRun * {
+    for (const auto &[engine, run] : engines) {
+      if (engine == name) {
+        return &run;
+      }
+    }
+    return nullptr;
+  };
+
+  bench::Config config;
+  config.engines = {"jarvis", "graham", "chan", "monotone", "quickhull"};
+  config.distributions = {"uniform"};
+  config.sizes = {100, 500, 1000, 5000, 10000, 25000, 50000};
+  std::string json_path = "results.json";
+
+  auto split = [](const std::string &list) {
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    for (std::string item; std::getline(stream, item, ',');) {
+      if (!item.empty()) {
+        items.push_back(item);
+      }
+    }
+    return items;
+  };
+  auto usage = [&](const std::string &error) {
+    std::cerr << error << "\n"
+              << "usage: ./stats [bench] [--engines a,b] [--dist d,e] "
+                 "[--sizes n,m] [--warmup k] [--runs k] [--seed s] "
+                 "[--cpu k|none] [--counters on|off] [--out path]\n"
+                 "engines:";
+    for (const auto &[name, run] : engines) {
+      std::cerr << " " << name;
+    }
+    std::cerr << "\ndistributions:";
+    for (const std::string &name : bench::distributionNames()) {
+      std::cerr << " " << name;
+    }
+    std::cerr << std::endl;
+    return 1;
+  };
+  try {
+    for (int i = 0; i < argc; i += 2) {
+      const std::string option = argv[i];
+      if (i + 1 >= argc) {
+        return usage("Missing value for " + option);
+      }
+      const std::string value = argv[i + 1];
+      if (option == "--engines") {
+        config.engines = split(value);
+      } else if (option == "--dist") {
+        config.distributions = split(value);
+      } else if (option == "--sizes") {
+        config.sizes.clear();
+        for (const std::string &size : split(value)) {
+          // std::stod so that 1e6 works too
+          config.sizes.push_back(static_cast<size_t>(std::stod(size)));
+        }
+      } else if (option == "--warmup") {
+        config.warmup = std::stoul(value);
+      } else if (option == "--runs") {
+        config.runs = std::stoul(value);
+      } else if (option == "--seed") {
+        config.seed = std::stoull(value);
+      } else if (option == "--cpu") {
+        config.pin = value != "none";
+        config.cpu = config.pin ? std::stoi(value) : -1;
+      } else if (option == "--counters") {
+        if (value != "on" && value != "off") {
+          return usage("--counters takes on or off");
+        }
+        config.counters = value == "on";
+      } else if (option == "--out") {
+        json_path = value;
+      } else {
+        return usage("Unknown option " + option);
+      }
+    }
+    for (const std::string &name : config.engines) {
+      if (find_engine(name) == nullptr) {
+        return usage("Unknown engine " + name);
+      }
+    }
+    for (const std::string &name : config.distributions) {
+      bench::generateDistribution(name, 0);
+    }
+  } catch (const std::exception &error) {
+    return usage(error.what());
+  }
+  if (config.runs == 0) {
+    return usage("At least one timed run is needed");
+  }
+
+  if (config.pin) {
+    config.pinned = bench::pinToCpu(config.cpu);
+    if (config.pinned < 0) {
+      std::cerr << "Could not pin to a CPU, running unpinned" << std::endl;
+    }
+  }
+
+  perf::PhaseProfiler profiler;
+  if (config.counters) {
+    for (int event = 0; event < perf::EVENTS; ++event) {
+      config.available[event] = profiler.available(perf::Event(event));
+    }
+    config.counters_error = profiler.error();
+    if (!config.counters_error.empty()) {
+      std::cerr << "Hardware counters missing (" << config.counters_error
+                << "), phases get their time only" << std::endl;
+    }
+  }
+  // the counters as "cycles 1.2e+06", or "-" for a missing one
+  auto print_counts = [&](const perf::Counts &counts) {
+    for (int event = 0; event < perf::EVENTS; ++event) {
+      std::cout << " " << perf::eventName(perf::Event(event)) << " ";
+      if (config.available[event]) {
+        std::cout << double(counts.events[event]);
+      } else {
+        std::cout << "-";
+      }
+    }
+  };
+
+  std::vector<bench::Measurement> measurements;
+  for (const std::string &distribution : config.distributions) {
+    for (size_t n : config.sizes) {
+      const std::vector<Point> points =
+          bench::generateDistribution(distribution, n, config.seed);
+      const size_t first = measurements.size();
+      for (const std::string &name : config.engines) {
+        const EngineRun &run = *find_engine(name);
+        bench::Measurement m = bench::measure([&] { return run(points); },
+                                              config.warmup, config.runs);
+        m.engine = name;
+        m.distribution = distribution;
+        m.n = n;
+        std::cout << std::left << std::setw(10) << distribution << " n="
+                  << std::setw(9) << n << std::setw(12) << name << std::right
+                  << " | median " << m.summary.median_ns << " ns"
+                  << " | p95 " << m.summary.p95_ns << " ns"
+                  << " | p99 " << m.summary.p99_ns << " ns"
+                  << " | h: " << m.hull_size;
+        if (measurements.size() > first &&
+            m.hull_size != measurements[first].hull_size) {
+          std::cout << " | DIFFERS FROM " << measurements[first].engine;
+        }
+        std::cout << std::endl;
+        if (config.counters) {
+          bench::profile([&] { return run(points); }, profiler, m);
+          std::cout << "    total" << std::setw(14) << m.total.time_ns
+                    << " ns |";
+          print_counts(m.total);
+          std::cout << std::endl;
+          for (const auto &[phase, counts] : m.phases) {
+            std::cout << "    " << std::left << std::setw(13) << phase
+                      << std::right << std::setw(6) << counts.time_ns
+                      << " ns |";
+            print_counts(counts);
+            std::cout << std::endl;
+          }
+        }
+        measurements.push_back(std::move(m));
+      }
+    }
+  }
+
+  std::ofstream outfile(json_path);
+  bench::writeJson(outfile, config, measurements);
+  outfile.close();
+  std::cout << "Results saved to " << json_path << std::endl;
   return 0;
 }
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && std::string(argv[1]) == "graham") {
+    graham_scaling();
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "prefilter") {
+    prefilter_comparison();
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "chan") {
+    chan_rounds();
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "threads") {
+    chan_threads(argc > 2 ? std::stoul(argv[2]) : 10000000);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "dc") {
+    divide_conquer(argc > 2 ? std::stoul(argv[2]) : 10000000);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "batch") {
+    batch_hulls(argc > 2 ? std::stoul(argv[2]) : 100000);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "chanpart") {
+    chan_partitioning(argc > 2 ? std::stoul(argv[2]) : 1000000);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "chantangent") {
+    chan_tangents(argc > 2 ? std::stoul(argv[2]) : 1000000);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "queries") {
+    hull_queries(argc > 2 ? std::stoul(argv[2]) : 1000000);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "calipers") {
+    hull_calipers();
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "approx") {
+    approximate_hulls(argc > 2 ? std::stoul(argv[2]) : 10000000);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "trace") {
+    trace_run(argc > 2 ? std::stoul(argv[2]) : 10000000,
+              argc > 3 ? argv[3] : "trace.json");
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "simd") {
+    simd_comparison();
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "predicates") {
+    predicates_comparison();
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "types") {
+    coordinate_types();
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "incremental") {
+    incremental_stream(argc > 2 ? std::stoul(argv[2]) : 1000000);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "window") {
+    sliding_window(argc > 2 ? std::stoul(argv[2]) : 1000000);
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "outofcore") {
+    out_of_core(argc > 2 ? std::stoul(argv[2]) : 100000000,
+                argc > 3 ? argv[3] : "points.bin");
+    return 0;
+  }
+  if (argc > 1 && std::string(argv[1]) == "io") {
+    file_io(argc > 2 ? std::stoul(argv[2]) : 10000000);
+    return 0;
+  }
+  if (argc > 2 && std::string(argv[1]) == "file") {
+    recorded_points(argv[2]);
+    return 0;
+  }
+
+  if (argc > 1 && std::string(argv[1]) == "bench") {
+    return benchmark(argc - 2, argv + 2);
+  }
+  return benchmark(argc - 1, argv + 1);
+}